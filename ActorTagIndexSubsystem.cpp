@@ -0,0 +1,213 @@
+#include "ActorTagIndexSubsystem.h"
+
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Engine/Level.h"
+
+void UActorTagIndexSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    UWorld* World = GetWorld();
+    check(World);
+
+    ActorSpawnedHandle = World->AddOnActorSpawnedHandler(
+        FOnActorSpawned::FDelegate::CreateUObject(this, &UActorTagIndexSubsystem::HandleActorSpawned));
+    ActorDestroyedHandle = World->AddOnActorDestroyedHandler(
+        FOnActorDestroyed::FDelegate::CreateUObject(this, &UActorTagIndexSubsystem::HandleActorDestroyed));
+
+    // ストリーミングで読み込まれたActorはスポーン通知が来ず、アンロード時も破棄通知が来ない
+    LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UActorTagIndexSubsystem::HandleLevelAddedToWorld);
+    LevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UActorTagIndexSubsystem::HandleLevelRemovedFromWorld);
+}
+
+void UActorTagIndexSubsystem::Deinitialize()
+{
+    if (UWorld* World = GetWorld())
+    {
+        World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+        World->RemoveOnActorDestroyedHandler(ActorDestroyedHandle);
+    }
+
+    FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+    FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedHandle);
+
+    TagToActors.Reset();
+    IndexedTags.Reset();
+
+    Super::Deinitialize();
+}
+
+void UActorTagIndexSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+    Super::OnWorldBeginPlay(InWorld);
+
+    // レベルに配置済みのActor（スポーン通知が来ないもの）をまとめて登録
+    for (TActorIterator<AActor> It(&InWorld); It; ++It)
+    {
+        IndexActor(*It);
+    }
+}
+
+void UActorTagIndexSubsystem::AddActorTag(AActor* Actor, const FName Tag)
+{
+    if (!Actor || Tag.IsNone())
+    {
+        return;
+    }
+
+    Actor->Tags.AddUnique(Tag);
+    IndexActor(Actor);
+}
+
+void UActorTagIndexSubsystem::RemoveActorTag(AActor* Actor, const FName Tag)
+{
+    if (!Actor || Tag.IsNone())
+    {
+        return;
+    }
+
+    Actor->Tags.Remove(Tag);
+    IndexActor(Actor);
+}
+
+void UActorTagIndexSubsystem::RefreshActor(AActor* Actor)
+{
+    IndexActor(Actor);
+}
+
+bool UActorTagIndexSubsystem::ActorHasTag(const AActor* Actor, const FName Tag) const
+{
+    if (!Actor || Tag.IsNone())
+    {
+        return false;
+    }
+
+    const TSet<TObjectKey<AActor>>* Actors = TagToActors.Find(Tag);
+    return Actors && Actors->Contains(TObjectKey<AActor>(Actor));
+}
+
+void UActorTagIndexSubsystem::GetActorsWithTag(const FName Tag, TArray<AActor*>& OutActors) const
+{
+    OutActors.Reset();
+
+    const TSet<TObjectKey<AActor>>* Actors = TagToActors.Find(Tag);
+    if (!Actors)
+    {
+        return;
+    }
+
+    OutActors.Reserve(Actors->Num());
+    for (const TObjectKey<AActor>& Key : *Actors)
+    {
+        if (AActor* Actor = Key.ResolveObjectPtr())
+        {
+            OutActors.Add(Actor);
+        }
+    }
+}
+
+TArray<AActor*> UActorTagIndexSubsystem::K2_GetActorsWithTag(const FName Tag) const
+{
+    TArray<AActor*> Actors;
+    GetActorsWithTag(Tag, Actors);
+    return Actors;
+}
+
+int32 UActorTagIndexSubsystem::GetNumActorsWithTag(const FName Tag) const
+{
+    const TSet<TObjectKey<AActor>>* Actors = TagToActors.Find(Tag);
+    return Actors ? Actors->Num() : 0;
+}
+
+void UActorTagIndexSubsystem::IndexActor(AActor* Actor)
+{
+    if (!Actor)
+    {
+        return;
+    }
+
+    // 古いタグを外してから現在の Tags で登録し直す
+    UnindexActor(Actor);
+
+    if (Actor->Tags.Num() == 0 || !IsValid(Actor))
+    {
+        return;
+    }
+
+    const TObjectKey<AActor> Key(Actor);
+    TArray<FName>& Tags = IndexedTags.Add(Key);
+
+    for (const FName Tag : Actor->Tags)
+    {
+        if (Tag.IsNone() || Tags.Contains(Tag))
+        {
+            continue;
+        }
+
+        Tags.Add(Tag);
+        TagToActors.FindOrAdd(Tag).Add(Key);
+    }
+}
+
+void UActorTagIndexSubsystem::UnindexActor(const AActor* Actor)
+{
+    TArray<FName> Tags;
+    if (!IndexedTags.RemoveAndCopyValue(TObjectKey<AActor>(Actor), Tags))
+    {
+        return;
+    }
+
+    for (const FName Tag : Tags)
+    {
+        if (TSet<TObjectKey<AActor>>* Actors = TagToActors.Find(Tag))
+        {
+            Actors->Remove(TObjectKey<AActor>(Actor));
+            if (Actors->Num() == 0)
+            {
+                TagToActors.Remove(Tag);
+            }
+        }
+    }
+}
+
+void UActorTagIndexSubsystem::HandleActorSpawned(AActor* Actor)
+{
+    IndexActor(Actor);
+}
+
+void UActorTagIndexSubsystem::HandleActorDestroyed(AActor* Actor)
+{
+    UnindexActor(Actor);
+}
+
+void UActorTagIndexSubsystem::HandleLevelAddedToWorld(ULevel* Level, UWorld* InWorld)
+{
+    // BeginPlay 前に読み込まれたレベルは OnWorldBeginPlay でまとめて登録される
+    if (!Level || InWorld != GetWorld() || !InWorld->HasBegunPlay())
+    {
+        return;
+    }
+
+    for (AActor* Actor : Level->Actors)
+    {
+        IndexActor(Actor);
+    }
+}
+
+void UActorTagIndexSubsystem::HandleLevelRemovedFromWorld(ULevel* Level, UWorld* InWorld)
+{
+    // Level が null なのはワールド全体の後始末（Deinitialize で全て消える）
+    if (!Level || InWorld != GetWorld())
+    {
+        return;
+    }
+
+    for (const AActor* Actor : Level->Actors)
+    {
+        if (Actor)
+        {
+            UnindexActor(Actor);
+        }
+    }
+}
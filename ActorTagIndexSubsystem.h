@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "ActorTagIndexSubsystem.generated.h"
+
+/**
+ * ワールド内の Actor タグ → Actor の索引。
+ *
+ * - BeginPlay 時点の全Actor、以降スポーンしたActor、後からストリーミングで追加されたレベル
+ *   （サブレベル・World Partition のセル）のActorを自動で登録（破棄・レベルの削除時に自動で削除）
+ * - AActor::Tags は変更通知が無いため、タグを変える場合は AddActorTag / RemoveActorTag を使うか、
+ *   直接書き換えた後に RefreshActor を呼んでください
+ * - 直接の書き換えに追従できない期間があるため、索引は候補の絞り込みに使い、最終判定は AActor::ActorHasTag で行うこと
+ * - 参照・更新はゲームスレッドのみ（ワーカーで使う場合はスナップショットを取ること）
+ */
+UCLASS()
+class UActorTagIndexSubsystem : public UWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // UWorldSubsystem
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+    virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+    /** Actor->Tags に追加し、索引も更新 */
+    UFUNCTION(BlueprintCallable, Category="ActorTagIndex")
+    void AddActorTag(AActor* Actor, FName Tag);
+
+    /** Actor->Tags から削除し、索引も更新 */
+    UFUNCTION(BlueprintCallable, Category="ActorTagIndex")
+    void RemoveActorTag(AActor* Actor, FName Tag);
+
+    /** Actor->Tags を直接書き換えた後に呼ぶ（索引を作り直す） */
+    UFUNCTION(BlueprintCallable, Category="ActorTagIndex")
+    void RefreshActor(AActor* Actor);
+
+    /** AActor::ActorHasTag と同じ結果を定数時間で返す */
+    bool ActorHasTag(const AActor* Actor, FName Tag) const;
+
+    /** Tag を持つ有効なActorを列挙（順不同） */
+    void GetActorsWithTag(FName Tag, TArray<AActor*>& OutActors) const;
+
+    UFUNCTION(BlueprintCallable, Category="ActorTagIndex", meta=(DisplayName="Get Actors With Tag"))
+    TArray<AActor*> K2_GetActorsWithTag(FName Tag) const;
+
+    /** Tag を持つActorの数（フィルタ方式の選択用） */
+    int32 GetNumActorsWithTag(FName Tag) const;
+
+private:
+    void IndexActor(AActor* Actor);
+    void UnindexActor(const AActor* Actor);
+
+    void HandleActorSpawned(AActor* Actor);
+    void HandleActorDestroyed(AActor* Actor);
+
+    void HandleLevelAddedToWorld(ULevel* Level, UWorld* InWorld);
+    void HandleLevelRemovedFromWorld(ULevel* Level, UWorld* InWorld);
+
+    TMap<FName, TSet<TObjectKey<AActor>>> TagToActors;
+
+    /** 索引に登録した時点のタグ（再登録時の差分削除用） */
+    TMap<TObjectKey<AActor>, TArray<FName>> IndexedTags;
+
+    FDelegateHandle ActorSpawnedHandle;
+    FDelegateHandle ActorDestroyedHandle;
+    FDelegateHandle LevelAddedHandle;
+    FDelegateHandle LevelRemovedHandle;
+};
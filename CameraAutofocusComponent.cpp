@@ -0,0 +1,373 @@
+#include "CameraAutofocusComponent.h"
+
+#include "Camera/CameraComponent.h"
+#include "CineCameraComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "UObject/UObjectGlobals.h"
+
+UCameraAutofocusComponent::UCameraAutofocusComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+
+    // カメラの移動後の姿勢でスイープを投げたいので、移動系の後に回す
+    PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UCameraAutofocusComponent::BeginPlay()
+{
+    Super::BeginPlay();
+
+    FocusQueryDelegate.BindUObject(this, &UCameraAutofocusComponent::HandleFocusQueryCompleted);
+    CacheGatherDelegate.BindUObject(this, &UCameraAutofocusComponent::HandleCacheGatherCompleted);
+    ResolveCamera();
+
+    // MultiSample のタスクはフレームをまたがせない（ワールドの更新・ストリーミング・GC と並行させない）
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UCameraAutofocusComponent::HandleWorldPostActorTick);
+    PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UCameraAutofocusComponent::HandlePreGarbageCollect);
+
+    // カメラごとに開始位相をずらす（同じ更新頻度のカメラが同じフレームに集中しないように）
+    TimeUntilNextQuery = UpdateRateHz > 0.0f ? FMath::FRand() / UpdateRateHz : 0.0f;
+}
+
+void UCameraAutofocusComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // 投げっぱなしの結果が届いても何もしないよう解除
+    FocusQueryDelegate.Unbind();
+    PendingQuery = FTraceHandle();
+    PendingFocusRecord.Reset();
+    CacheGatherDelegate.Unbind();
+    PendingCacheGather = FTraceHandle();
+    PendingCacheStore = FPendingCacheStore();
+
+    // World を参照しているタスクが残らないよう待つ
+    FinishPendingEstimate();
+    PendingEstimateResult.Reset();
+
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+    PostActorTickHandle.Reset();
+    FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+    PreGarbageCollectHandle.Reset();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void UCameraAutofocusComponent::FinishPendingEstimate()
+{
+    // 結果の反映は次の TickComponent（完了済みなので待たない）
+    if (PendingEstimateResult)
+    {
+        PendingEstimate.Wait();
+    }
+}
+
+void UCameraAutofocusComponent::HandleWorldPostActorTick(UWorld* InWorld, const ELevelTick TickType, const float DeltaSeconds)
+{
+    if (InWorld == GetWorld())
+    {
+        FinishPendingEstimate();
+    }
+}
+
+void UCameraAutofocusComponent::HandlePreGarbageCollect()
+{
+    FinishPendingEstimate();
+}
+
+UCameraComponent* UCameraAutofocusComponent::ResolveCamera()
+{
+    if (!Camera.IsValid())
+    {
+        if (const AActor* Owner = GetOwner())
+        {
+            Camera = Owner->FindComponentByClass<UCameraComponent>();
+        }
+    }
+    return Camera.Get();
+}
+
+void UCameraAutofocusComponent::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    TimeUntilNextQuery -= DeltaTime;
+
+    if (PendingEstimateResult && PendingEstimate.IsCompleted())
+    {
+        const bool bHit = PendingEstimate.GetResult();
+        const FFocusEstimate& Estimate = *PendingEstimateResult;
+
+        LastConfidence = bHit ? Estimate.Confidence : 0.0f;
+        if (!bHit || Estimate.Confidence >= MinConfidence)
+        {
+            ApplyQueryResult(bHit, Estimate.FocusDistanceCm);
+        }
+        PendingEstimateResult.Reset();
+    }
+
+    // 前回の結果が届くまでは次を投げない（結果は早ければ次のフレームに届く）
+    if (TimeUntilNextQuery <= 0.0f && !PendingQuery.IsValid() && !PendingEstimateResult)
+    {
+        IssueFocusQuery();
+        TimeUntilNextQuery = UpdateRateHz > 0.0f
+            ? FMath::Max(TimeUntilNextQuery + 1.0f / UpdateRateHz, 0.0f)
+            : 0.0f;
+    }
+
+    if (!bHasFocusDistance)
+    {
+        return;
+    }
+
+    SmoothedFocusDistanceCm = FocusInterpSpeed > 0.0f
+        ? FMath::FInterpTo(SmoothedFocusDistanceCm, TargetFocusDistanceCm, DeltaTime, FocusInterpSpeed)
+        : TargetFocusDistanceCm;
+
+    if (bApplyToCineCamera)
+    {
+        if (UCineCameraComponent* CineCamera = Cast<UCineCameraComponent>(Camera.Get()))
+        {
+            CineCamera->FocusSettings.FocusMethod = ECameraFocusMethod::Manual;
+            CineCamera->FocusSettings.ManualFocusDistance = SmoothedFocusDistanceCm;
+        }
+    }
+}
+
+void UCameraAutofocusComponent::IssueFocusQuery()
+{
+    UWorld* World = GetWorld();
+    FVector CamPos;
+    FQuat CamRot;
+    FVector TargetCenter;
+    if (!World || !GetCurrentFocusPose(CamPos, CamRot, TargetCenter))
+    {
+        return;
+    }
+
+    if (Method == EAutofocusMethod::MultiSample)
+    {
+        IssueMultiSampleQuery(CamPos, CamRot, TargetCenter);
+        return;
+    }
+
+    if (bUseMovementCache)
+    {
+        FocusCache.Tolerances.CameraPositionCm = CacheCameraPositionToleranceCm;
+        FocusCache.Tolerances.CameraRotationDeg = CacheCameraRotationToleranceDeg;
+        FocusCache.Tolerances.TargetPositionCm = CacheTargetPositionToleranceCm;
+        FocusCache.Tolerances.MaxAgeSeconds = CacheMaxAgeSeconds;
+        FocusCache.StationaryQueriesBeforeStore = CacheStationaryQueriesBeforeStore;
+
+        bool bCachedHit = false;
+        float CachedDistance = 0.0f;
+        if (FocusCache.TryGet(World, CamPos, CamRot, TargetCenter, SlabSizeCm, SlabThicknessCm, bCachedHit, CachedDistance))
+        {
+            ApplyQueryResult(bCachedHit, CachedDistance);
+            return;
+        }
+    }
+
+    // 動き続けている間は保存してもすぐ外れるので、周辺の Overlap は静止している時だけ
+    const bool bStoreInCache = bUseMovementCache && FocusCache.NoteMissAndShouldStore(CamPos, CamRot, TargetCenter);
+
+    FFocusSlabQuery Query;
+    if (!MakeFocusSlabQuery(CamPos, CamRot, TargetCenter, SlabSizeCm, SlabThicknessCm, Query))
+    {
+        return;
+    }
+
+    FCollisionObjectQueryParams ObjParams;
+    ObjParams.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldDynamic);
+
+    FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FocusSlabSweepAsync), /*bTraceComplex=*/false);
+
+    // 深度はスイープを投げた時点のカメラ姿勢で測る（Datum の Start / Rot に残る）
+    PendingQuery = World->AsyncSweepByObjectType(
+        EAsyncTraceType::Single,
+        Query.Start,
+        Query.End,
+        Query.Orientation,
+        ObjParams,
+        Query.Shape,
+        QueryParams,
+        &FocusQueryDelegate
+    );
+
+    // 記録中なら入力は投げた時点のもの、結果は HandleFocusQueryCompleted で埋める
+    PendingFocusRecord.Reset();
+    if (FSceneQueryRecorder::IsRecording())
+    {
+        FFocusSlabRecord& Record = PendingFocusRecord.Emplace();
+        Record.CamPos = CamPos;
+        Record.CamRot = CamRot;
+        Record.TargetCenter = TargetCenter;
+        Record.SlabSizeCm = SlabSizeCm;
+        Record.SlabThicknessCm = SlabThicknessCm;
+    }
+
+    // 周辺の物体はスイープと同じフレーム（同じシーンの状態）で集める
+    PendingCacheStore = FPendingCacheStore();
+    PendingCacheGather = FTraceHandle();
+    if (bStoreInCache)
+    {
+        IssueCacheGather(World, CamPos, CamRot, TargetCenter);
+    }
+}
+
+bool UCameraAutofocusComponent::GetCurrentFocusPose(FVector& OutCamPos, FQuat& OutCamRot, FVector& OutTargetCenter)
+{
+    const UCameraComponent* CameraComponent = ResolveCamera();
+    if (!CameraComponent || !TargetActor)
+    {
+        return false;
+    }
+
+    OutCamPos = CameraComponent->GetComponentLocation();
+    OutCamRot = CameraComponent->GetComponentQuat();
+    OutTargetCenter = TargetActor->GetComponentsBoundingBox().GetCenter() + TargetOffset;
+    return true;
+}
+
+void UCameraAutofocusComponent::HandleFocusQueryCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    if (Handle != PendingQuery)
+    {
+        return;
+    }
+    PendingQuery = FTraceHandle();
+
+    float Distance = 0.0f;
+    const bool bHit = Datum.OutHits.Num() > 0
+        && Datum.OutHits[0].bBlockingHit
+        && GetFocusDistanceFromHit(Datum.Start, Datum.Rot, Datum.OutHits[0], Distance);
+
+    if (PendingFocusRecord.IsSet())
+    {
+        // 距離は投げた時点の姿勢（Datum.Start / Rot）から測ったもの。実行時間はワーカー側なので測れず 0
+        FFocusSlabRecord& Record = PendingFocusRecord.GetValue();
+        Record.bHit = bHit;
+        Record.FocusDistanceCm = bHit ? Distance : 0.0f;
+        FSceneQueryRecorder::RecordFocusSlab(Record, 0.0);
+        PendingFocusRecord.Reset();
+    }
+
+    if (PendingCacheStore.bActive)
+    {
+        PendingCacheStore.bSweepDone = true;
+        PendingCacheStore.bHit = bHit;
+        PendingCacheStore.FocusDistanceCm = Distance;
+        TryFinishCacheStore();
+    }
+
+    LastConfidence = bHit ? 1.0f : 0.0f;
+    ApplyQueryResult(bHit, Distance);
+}
+
+void UCameraAutofocusComponent::IssueCacheGather(UWorld* World, const FVector& CamPos, const FQuat& CamRot, const FVector& TargetCenter)
+{
+    FBox GatherBounds;
+    if (!FocusCache.GetGatherBounds(CamPos, CamRot, TargetCenter, SlabSizeCm, SlabThicknessCm, GatherBounds))
+    {
+        return;
+    }
+
+    // FFocusSlabCache::Store と同じ範囲・同じオブジェクトタイプ（ゲームスレッドで同期 Overlap しない）
+    FCollisionObjectQueryParams ObjParams;
+    ObjParams.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldDynamic);
+
+    const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FocusSlabCacheGatherAsync), /*bTraceComplex=*/false);
+
+    PendingCacheStore.bActive = true;
+    PendingCacheStore.CamPos = CamPos;
+    PendingCacheStore.CamRot = CamRot;
+    PendingCacheStore.TargetCenter = TargetCenter;
+    PendingCacheStore.SlabSizeCm = SlabSizeCm;
+    PendingCacheStore.SlabThicknessCm = SlabThicknessCm;
+
+    PendingCacheGather = World->AsyncOverlapByObjectType(
+        GatherBounds.GetCenter(),
+        FQuat::Identity,
+        ObjParams,
+        FCollisionShape::MakeBox(GatherBounds.GetExtent()),
+        QueryParams,
+        &CacheGatherDelegate
+    );
+}
+
+void UCameraAutofocusComponent::HandleCacheGatherCompleted(const FTraceHandle& Handle, FOverlapDatum& Datum)
+{
+    // 後のスイープで投げ直した場合は古い方を捨てる
+    if (Handle != PendingCacheGather || !PendingCacheStore.bActive)
+    {
+        return;
+    }
+    PendingCacheGather = FTraceHandle();
+
+    PendingCacheStore.bGatherDone = true;
+    PendingCacheStore.Overlaps = MoveTemp(Datum.OutOverlaps);
+    TryFinishCacheStore();
+}
+
+void UCameraAutofocusComponent::TryFinishCacheStore()
+{
+    FPendingCacheStore& Pending = PendingCacheStore;
+    if (!Pending.bSweepDone || !Pending.bGatherDone)
+    {
+        return;
+    }
+
+    // 周辺のプリミティブの Transform は保存時（結果が届いた時）に記録するので、
+    // 投げてから届くまでにカメラ・被写体が動いていたら保存しない
+    FVector CamPos;
+    FQuat CamRot;
+    FVector TargetCenter;
+    if (bUseMovementCache
+        && GetCurrentFocusPose(CamPos, CamRot, TargetCenter)
+        && FocusCache.IsPoseWithinTolerances(CamPos, CamRot, TargetCenter, Pending.CamPos, Pending.CamRot, Pending.TargetCenter))
+    {
+        FocusCache.Store(GetWorld(), Pending.CamPos, Pending.CamRot, Pending.TargetCenter, Pending.SlabSizeCm, Pending.SlabThicknessCm,
+            Pending.bHit, Pending.FocusDistanceCm, Pending.Overlaps);
+    }
+
+    PendingCacheStore = FPendingCacheStore();
+}
+
+void UCameraAutofocusComponent::IssueMultiSampleQuery(const FVector& CamPos, const FQuat& CamRot, const FVector& TargetCenter)
+{
+    FFocusSampleSettings Settings;
+    Settings.GridSize = SampleGridSize;
+    Settings.PatternSizeCm = SlabSizeCm;
+    Settings.Percentile = SamplePercentile;
+
+    PendingEstimateResult = MakeShared<FFocusEstimate, ESPMode::ThreadSafe>();
+    PendingEstimate = UE::Tasks::Launch(
+        UE_SOURCE_LOCATION,
+        [World = GetWorld(), CamPos, CamRot, TargetCenter, Settings, Result = PendingEstimateResult]()
+        {
+            return EstimateFocusDistanceMultiSample(World, CamPos, CamRot, TargetCenter, Settings, *Result);
+        }
+    );
+}
+
+void UCameraAutofocusComponent::ApplyQueryResult(const bool bHit, float Distance)
+{
+    bLastQueryHit = bHit;
+
+    if (!bLastQueryHit)
+    {
+        if (FallbackFocusDistanceCm <= 0.0f)
+        {
+            return;
+        }
+        Distance = FallbackFocusDistanceCm;
+    }
+
+    TargetFocusDistanceCm = Distance;
+
+    // 最初の結果は平滑化せずにそのまま使う
+    if (!bHasFocusDistance)
+    {
+        SmoothedFocusDistanceCm = Distance;
+        bHasFocusDistance = true;
+    }
+}
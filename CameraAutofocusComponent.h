@@ -0,0 +1,209 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "WorldCollision.h"
+#include "Tasks/Task.h"
+#include "test.h"
+#include "SceneQueryRecorder.h"
+#include "CameraAutofocusComponent.generated.h"
+
+class UCameraComponent;
+class UCineCameraComponent;
+
+UENUM(BlueprintType)
+enum class EAutofocusMethod : uint8
+{
+    /** 板（薄いBox）のスイープ1回。最も手前のヒット */
+    SlabSweep,
+
+    /** 格子状のライントレース群の深度の重み付きパーセンタイル（EstimateFocusDistanceMultiSample） */
+    MultiSample,
+};
+
+/**
+ * フォーカス板スイープ（SweepFocusSlabAndGetForwardDistance と同じ板・同じ深度）でカメラのピントを合わせます。
+ *
+ * - スイープは非同期トレースで投げ、結果が届くまでは前回の結果を使う（ゲームスレッドで待たない）
+ * - SceneQueryRecorder で記録中は、スイープを FocusSlab として記録（入力は投げた時点、結果は届いた時点）
+ * - 更新頻度はカメラごとに指定（開始位相はばらして、複数カメラのトレースが同じフレームに集中しないようにする）
+ * - ピント距離は FocusInterpSpeed で時間方向に平滑化
+ * - 所有Actorの最初の UCameraComponent の姿勢を使い、UCineCameraComponent ならマニュアルフォーカス距離に反映
+ * - MultiSample はワーカーでまとめて実行し、信頼度が MinConfidence 未満の結果は捨てる
+ *   （投げたフレームのアクターの Tick の後・GC の前に完了を待つ。結果は次のフレームの Tick で反映）
+ * - SlabSweep は FFocusSlabCache を通し、カメラ・被写体・周辺の物体が動いていなければスイープを省く
+ *   （キャッシュに保存する周辺の物体は、静止している時だけスイープと同じフレームに非同期 Overlap で集める）
+ */
+UCLASS(ClassGroup=(Camera), meta=(BlueprintSpawnableComponent))
+class UCameraAutofocusComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    UCameraAutofocusComponent();
+
+    /** ピントを合わせる被写体（中心は Bounds の中心 + TargetOffset） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus")
+    TObjectPtr<AActor> TargetActor;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus")
+    FVector TargetOffset = FVector::ZeroVector;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus")
+    EAutofocusMethod Method = EAutofocusMethod::SlabSweep;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus", meta=(ClampMin="1.0"))
+    float SlabSizeCm = 200.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus", meta=(ClampMin="0.1"))
+    float SlabThicknessCm = 10.0f;
+
+    /** MultiSample: 格子の一辺の本数（サンプル数はこの2乗）。格子の大きさは SlabSizeCm */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus|MultiSample", meta=(ClampMin="1", ClampMax="16"))
+    int32 SampleGridSize = 5;
+
+    /** MultiSample: 採用する深度のパーセンタイル（0.5 = 中央値） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus|MultiSample", meta=(ClampMin="0.0", ClampMax="1.0"))
+    float SamplePercentile = 0.5f;
+
+    /** MultiSample: これ未満の信頼度の結果は使わない（前回の距離を維持） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus|MultiSample", meta=(ClampMin="0.0", ClampMax="1.0"))
+    float MinConfidence = 0.3f;
+
+    /** SlabSweep: 何も動いていない間は前回の結果を使う（FFocusSlabCache） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus|Cache")
+    bool bUseMovementCache = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus|Cache", meta=(ClampMin="0.0", EditCondition="bUseMovementCache"))
+    float CacheCameraPositionToleranceCm = 1.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus|Cache", meta=(ClampMin="0.0", EditCondition="bUseMovementCache"))
+    float CacheCameraRotationToleranceDeg = 0.1f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus|Cache", meta=(ClampMin="0.0", EditCondition="bUseMovementCache"))
+    float CacheTargetPositionToleranceCm = 1.0f;
+
+    /** 静止したスイープがこの回数続いたら、結果をキャッシュに保存する（動いている間は周辺の Overlap を掛けない） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus|Cache", meta=(ClampMin="0", EditCondition="bUseMovementCache"))
+    int32 CacheStationaryQueriesBeforeStore = 2;
+
+    /** キャッシュした結果を使い続ける最長時間（秒。範囲外から入ってくる物体の取りこぼし対策） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus|Cache", meta=(ClampMin="0.0", EditCondition="bUseMovementCache"))
+    float CacheMaxAgeSeconds = 1.0f;
+
+    /** 1秒あたりのスイープ回数（0 以下なら毎フレーム。ただし前回の結果が届くまでは次を投げない） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus", meta=(ClampMin="0.0"))
+    float UpdateRateHz = 10.0f;
+
+    /** ピント距離の追従速度（FInterpTo。0 なら結果に即座に合わせる） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus", meta=(ClampMin="0.0"))
+    float FocusInterpSpeed = 6.0f;
+
+    /** 外れた場合に使う距離（cm）。0 以下なら直前の距離を維持 */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus")
+    float FallbackFocusDistanceCm = 0.0f;
+
+    /** UCineCameraComponent のフォーカス設定に反映するか */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Autofocus")
+    bool bApplyToCineCamera = true;
+
+    /** 平滑化後のピント距離（cm）。まだ一度も決まっていなければ 0 */
+    UFUNCTION(BlueprintPure, Category="Autofocus")
+    float GetFocusDistance() const { return SmoothedFocusDistanceCm; }
+
+    /** 直近に届いたスイープ結果が被写体側に当たったか */
+    UFUNCTION(BlueprintPure, Category="Autofocus")
+    bool HasFocusHit() const { return bLastQueryHit; }
+
+    /** 直近の MultiSample 推定の信頼度（SlabSweep では当たれば 1） */
+    UFUNCTION(BlueprintPure, Category="Autofocus")
+    float GetFocusConfidence() const { return LastConfidence; }
+
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+private:
+    /** 今の姿勢で非同期スイープを投げる */
+    void IssueFocusQuery();
+
+    /** MultiSample 推定をワーカーで開始 */
+    void IssueMultiSampleQuery(const FVector& CamPos, const FQuat& CamRot, const FVector& TargetCenter);
+
+    /** 非同期スイープの完了（ゲームスレッド、投げた次のフレーム以降） */
+    void HandleFocusQueryCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+    /** スイープと同じ姿勢でキャッシュ用の周辺の物体を非同期 Overlap で集め始める */
+    void IssueCacheGather(UWorld* World, const FVector& CamPos, const FQuat& CamRot, const FVector& TargetCenter);
+
+    /** 非同期 Overlap の完了。スイープ結果と揃ったらキャッシュへ保存 */
+    void HandleCacheGatherCompleted(const FTraceHandle& Handle, FOverlapDatum& Datum);
+
+    /** スイープと Overlap の両方が届いていれば、カメラ・被写体がその間に動いていない時だけ保存する */
+    void TryFinishCacheStore();
+
+    /** 今のカメラ・被写体の姿勢（無ければ false） */
+    bool GetCurrentFocusPose(FVector& OutCamPos, FQuat& OutCamRot, FVector& OutTargetCenter);
+
+    /** 届いた距離を平滑化の目標にする（外れなら FallbackFocusDistanceCm） */
+    void ApplyQueryResult(bool bHit, float Distance);
+
+    UCameraComponent* ResolveCamera();
+
+    /** 実行中の MultiSample 推定の完了を待つ（フレームの終わり・GC の前・EndPlay） */
+    void FinishPendingEstimate();
+
+    void HandleWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+    void HandlePreGarbageCollect();
+
+    FDelegateHandle PostActorTickHandle;
+    FDelegateHandle PreGarbageCollectHandle;
+
+    TWeakObjectPtr<UCameraComponent> Camera;
+
+    FTraceDelegate FocusQueryDelegate;
+    FTraceHandle PendingQuery;
+
+    /** SceneQueryRecorder で記録中に投げたスイープの入力（結果が届いたら書き出す） */
+    TOptional<FFocusSlabRecord> PendingFocusRecord;
+
+    /** 実行中の MultiSample 推定（Tick で完了を見る） */
+    UE::Tasks::TTask<bool> PendingEstimate;
+    TSharedPtr<FFocusEstimate, ESPMode::ThreadSafe> PendingEstimateResult;
+
+    FFocusSlabCache FocusCache;
+
+    /** 同じフレームに投げたスイープと周辺の Overlap の結果（両方揃ったら保存） */
+    struct FPendingCacheStore
+    {
+        bool bActive = false;
+
+        /** 投げた時の姿勢 */
+        FVector CamPos = FVector::ZeroVector;
+        FQuat CamRot = FQuat::Identity;
+        FVector TargetCenter = FVector::ZeroVector;
+        float SlabSizeCm = 0.0f;
+        float SlabThicknessCm = 0.0f;
+
+        bool bSweepDone = false;
+        bool bHit = false;
+        float FocusDistanceCm = 0.0f;
+
+        bool bGatherDone = false;
+        TArray<FOverlapResult> Overlaps;
+    };
+
+    FOverlapDelegate CacheGatherDelegate;
+    FTraceHandle PendingCacheGather;
+    FPendingCacheStore PendingCacheStore;
+
+    /** 次のスイープまでの残り時間（秒） */
+    float TimeUntilNextQuery = 0.0f;
+
+    /** 最後に届いた結果の距離（平滑化の目標） */
+    float TargetFocusDistanceCm = 0.0f;
+    float SmoothedFocusDistanceCm = 0.0f;
+    bool bHasFocusDistance = false;
+    bool bLastQueryHit = false;
+    float LastConfidence = 0.0f;
+};
@@ -1,20 +1,20 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#include "CvCurve.h"
-
-#define LOCTEXT_NAMESPACE "FCvCurveModule"
-
-void FCvCurveModule::StartupModule()
-{
-	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
-}
-
-void FCvCurveModule::ShutdownModule()
-{
-	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
-	// we call this function before unloading the module.
-}
-
-#undef LOCTEXT_NAMESPACE
-	
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CvCurve.h"
+
+#define LOCTEXT_NAMESPACE "FCvCurveModule"
+
+void FCvCurveModule::StartupModule()
+{
+	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
+}
+
+void FCvCurveModule::ShutdownModule()
+{
+	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
+	// we call this function before unloading the module.
+}
+
+#undef LOCTEXT_NAMESPACE
+	
 IMPLEMENT_MODULE(FCvCurveModule, CvCurve)
\ No newline at end of file
@@ -1,329 +1,406 @@
-#include "CvCurveComponent.h"
-
-
-// Sets default values for this component's properties
-UCvCurveComponent::UCvCurveComponent()
-{
-	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
-	// off to improve performance if you don't need them.
-	PrimaryComponentTick.bCanEverTick = true;
-}
-
-
-// Called when the game starts
-void UCvCurveComponent::BeginPlay()
-{
-	Super::BeginPlay();
-
-	
-}
-
-
-// Called every frame
-void UCvCurveComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
-{
-	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-}
-
-
-void UCvCurveComponent::OnComponentCreated()
-{
-	Super::OnComponentCreated();
-
-}
-
-void UCvCurveComponent::OnRegister()
-{
-	Super::OnRegister();
-
-
-
-	const int32 NumPoints = GetNumberOfSplinePoints();
-	for (int32 i = 0; i < NumPoints; ++i)
-	{
-		SetSplinePointType(i, ESplinePointType::Linear, true);
-	}
-
-    UpdateCurveDataFromSpline();
-    BuildArcLengthTable(1000);
-    
-#if WITH_EDITORONLY_DATA
-    EditorUnselectedSplineSegmentColor = FLinearColor::Yellow;
-    UpdateNurbsVisualization_DebugDraw();
-#endif
-
-}
-
-
-void UCvCurveComponent::UpdateCurveDataFromSpline()
-{
-    const int32 NumPoints = GetNumberOfSplinePoints();
-
-    if (NumPoints < 4)
-    {
-        CVPoints.Empty();
-        Weights.Empty();
-        KnotVector.Empty();
-        return;
-    }
-
-    CVPoints.SetNum(NumPoints);
-    for (int32 i = 0; i < NumPoints; ++i)
-    {
-        CVPoints[i] = GetLocationAtSplinePoint(i, ESplineCoordinateSpace::World);
-    }
-
-    Weights.Init(1.0f, CVPoints.Num());
-    GenerateDefaultKnotVector();
-
-}
-
-void UCvCurveComponent::GenerateDefaultKnotVector()
-{
-    const int32 NumCV = CVPoints.Num();
-    const int32 n = NumCV - 1;
-    const int32 m = n + Degree + 1;
-
-    KnotVector.Empty();
-
-    for (int32 i = 0; i <= m; ++i)
-    {
-        if (i < Degree)
-        {
-            KnotVector.Add(0.0f);
-        }
-        else if (i > n)
-        {
-            KnotVector.Add(1.0f);
-        }
-        else
-        {
-            float Value = static_cast<float>(i - Degree) / (n - Degree + 1);
-            KnotVector.Add(Value);
-        }
-    }
-}
-
-float UCvCurveComponent::BasisFunction(int i, int p, float u) const
-{
-    const TArray<float>& U = KnotVector;
-
-    if (p == 0)
-    {
-        bool bIsLastSpan = (i + 1 == U.Num() - 1);
-        bool bInSpan = (u >= U[i] && u < U[i + 1]);
-        if (bInSpan || (bIsLastSpan && FMath::IsNearlyEqual(u, U.Last())))
-        {
-            return 1.0f;
-        }
-        return 0.0f;
-    }
-
-    float Denom1 = U[i + p] - U[i];
-    float Denom2 = U[i + p + 1] - U[i + 1];
-
-    float Term1 = 0.0f;
-    float Term2 = 0.0f;
-
-    if (Denom1 > KINDA_SMALL_NUMBER)
-    {
-        Term1 = ((u - U[i]) / Denom1) * BasisFunction(i, p - 1, u);
-    }
-
-    if (Denom2 > KINDA_SMALL_NUMBER)
-    {
-        Term2 = ((U[i + p + 1] - u) / Denom2) * BasisFunction(i + 1, p - 1, u);
-    }
-
-    return Term1 + Term2;
-}
-
-FVector UCvCurveComponent::EvaluateAt(float u) const
-{
-    const int32 NumCV = CVPoints.Num();
-    const int32 n = NumCV - 1;
-    const int32 m = n + Degree + 1;
-
-    if (NumCV < 4 || KnotVector.Num() < m + 1)
-    {
-        UE_LOG(LogTemp, Error, TEXT("EvaluateAt: Invalid NURBS configuration"));
-        return FVector::ZeroVector;
-    }
-
-    FVector Numerator = FVector::ZeroVector;
-    float Denominator = 0.0f;
-
-    for (int32 i = 0; i <= n; ++i)
-    {
-        float N = BasisFunction(i, Degree, u);
-        float W = Weights[i];
-
-        Numerator += N * W * CVPoints[i];
-        Denominator += N * W;
-    }
-
-    if (Denominator < KINDA_SMALL_NUMBER)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("EvaluateAt: Denominator too small at u=%f"), u);
-        return FVector::ZeroVector;
-    }
-
-    return Numerator / Denominator;
-}
-
-
-void UCvCurveComponent::BuildArcLengthTable(int32 NumSamples)
-{
-    ArcLengthTable.Empty();
-
-    if (CVPoints.Num() < 4 || KnotVector.Num() == 0) return;
-
-    float u_min = KnotVector[Degree];
-    float u_max = KnotVector[KnotVector.Num() - Degree - 1];
-    float AdjustedUMax = u_max - KINDA_SMALL_NUMBER;
-
-    // Step 1: Raw sampleixj
-    struct FSamplePoint
-    {
-        float U;
-        float Distance;
-    };
-
-    TArray<FSamplePoint> RawSamples;
-    RawSamples.Reserve(NumSamples + 1);
-
-    FVector Prev = EvaluateAt(u_min);
-    float Total = 0.0f;
-
-    RawSamples.Add({ u_min, 0.0f });
-
-    for (int32 i = 1; i <= NumSamples; ++i)
-    {
-        float Alpha = i / static_cast<float>(NumSamples);
-        float u = FMath::Lerp(u_min, AdjustedUMax, Alpha);
-        FVector Curr = EvaluateAt(u);
-        Total += FVector::Dist(Prev, Curr);
-
-        RawSamples.Add({ u, Total });
-        Prev = Curr;
-    }
-
-    CurveTotalLength = Total;
-
-    // Step 2: TvOiN=100Ȃ0%,1%,2%...j
-    int32 EquiDistSamples = 100;
-    ArcLengthTable.Reserve(EquiDistSamples + 1);
-
-    for (int32 i = 0; i <= EquiDistSamples; ++i)
-    {
-        float TargetDist = Total * (i / static_cast<float>(EquiDistSamples));
-
-        // RawSamples狗ɋ߂2_T
-        for (int32 j = 1; j < RawSamples.Num(); ++j)
-        {
-            if (RawSamples[j].Distance >= TargetDist)
-            {
-                const FSamplePoint& A = RawSamples[j - 1];
-                const FSamplePoint& B = RawSamples[j];
-
-                float Alpha = (TargetDist - A.Distance) / (B.Distance - A.Distance);
-                float InterpolatedU = FMath::Lerp(A.U, B.U, Alpha);
-
-                ArcLengthTable.Add({ InterpolatedU, TargetDist });
-                break;
-            }
-        }
-    }
-}
-
-float UCvCurveComponent::FindUByDistance(float Distance) const
-{
-    if (ArcLengthTable.Num() < 2) return 0.0f;
-
-    for (int32 i = 1; i < ArcLengthTable.Num(); ++i)
-    {
-        float D0 = ArcLengthTable[i - 1].Distance;
-        float D1 = ArcLengthTable[i].Distance;
-
-        if (Distance >= D0 && Distance <= D1)
-        {
-            float Alpha = (Distance - D0) / (D1 - D0);
-            return FMath::Lerp(ArcLengthTable[i - 1].U, ArcLengthTable[i].U, Alpha);
-        }
-    }
-
-    return ArcLengthTable.Last().U;
-}
-
-
-FTransform UCvCurveComponent::GetTransformAtDistance(float Distance) const
-{
-    if (CurveTotalLength <= 0.0f || ArcLengthTable.Num() < 2)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("GetTransformAtDistance: Arc length table is not ready"));
-        return FTransform::Identity;
-    }
-
-    Distance = FMath::Clamp(Distance, 0.0f, CurveTotalLength);
-    float u = FindUByDistance(Distance);
-
-    u = FMath::Clamp(u, KnotVector[Degree], KnotVector.Last() - 0.0001f);
-
-    const float Epsilon = 0.0005f;
-    float uBack = FMath::Clamp(u - Epsilon, KnotVector[Degree], KnotVector.Last());
-
-    FVector PosA = EvaluateAt(uBack);
-    FVector PosB = EvaluateAt(u);
-    FVector Tangent = (PosB - PosA).GetSafeNormal();
-
-    if (Tangent.IsNearlyZero())
-    {
-        Tangent = FVector::ForwardVector;
-    }
-
-    FRotator Rotation = Tangent.Rotation();
-    return FTransform(Rotation, PosB);
-}
-
-float UCvCurveComponent::GetCurveLength() const
-{
-    return CurveTotalLength;
-}
-
-void UCvCurveComponent::UpdateNurbsVisualization_DebugDraw()
-{
-
-    UWorld* World = GetWorld();
-
-    if (!World || CVPoints.Num() < 4 || KnotVector.Num() == 0) return;
-
-    FlushPersistentDebugLines(World);
-
-    const int32 NumSegments = 1000;
-    const float SegmentLength = CurveTotalLength / NumSegments;
-
-    FVector PrevPos = EvaluateAt(FindUByDistance(0.0f));
-
-    for (int32 i = 1; i <= NumSegments; ++i)
-    {
-        float Distance = i * SegmentLength;
-        float u = FindUByDistance(Distance);
-        FVector CurrPos = EvaluateAt(u);
-
-        if (!World->IsGameWorld())
-        {
-            DrawDebugLine(
-                World,
-                PrevPos,
-                CurrPos,
-                FColor::White,
-                true,      // persistent (until new construction)
-                0.0f,
-                0,
-                2.0f
-            );
-        }
-        PrevPos = CurrPos;
-    }
+#include "CvCurveComponent.h"
+
+#include "CvCurveNurbs.h"
+
+
+// Sets default values for this component's properties
+UCvCurveComponent::UCvCurveComponent()
+{
+	// Set this component to be initialized when the game starts, and to be ticked every frame.  You can turn these features
+	// off to improve performance if you don't need them.
+	PrimaryComponentTick.bCanEverTick = true;
+}
+
+
+// Called when the game starts
+void UCvCurveComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	
+}
+
+
+// Called every frame
+void UCvCurveComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+}
+
+
+void UCvCurveComponent::OnComponentCreated()
+{
+	Super::OnComponentCreated();
+
+}
+
+void UCvCurveComponent::OnRegister()
+{
+	Super::OnRegister();
+
+
+
+	const int32 NumPoints = GetNumberOfSplinePoints();
+	for (int32 i = 0; i < NumPoints; ++i)
+	{
+		SetSplinePointType(i, ESplinePointType::Linear, true);
+	}
+
+    UpdateCurveDataFromSpline();
+    BuildArcLengthTable(ArcLengthTolerance);
+    PublishCurveView();
+    
+#if WITH_EDITORONLY_DATA
+    EditorUnselectedSplineSegmentColor = FLinearColor::Yellow;
+    UpdateNurbsVisualization_DebugDraw();
+#endif
+
+}
+
+
+void UCvCurveComponent::UpdateCurveDataFromSpline()
+{
+    const int32 NumPoints = GetNumberOfSplinePoints();
+
+    Degree = FMath::Clamp(Degree, CvCurveMinDegree, CvCurveMaxDegree);
+    Evaluator = CvCurveNurbs::GetEvaluator(Degree);
+    DerivativeEvaluator = CvCurveNurbs::GetDerivativeEvaluator(Degree);
+
+    if (NumPoints < Degree + 1)
+    {
+        CVPoints.Empty();
+        Weights.Empty();
+        KnotVector.Empty();
+        return;
+    }
+
+    CVPoints.SetNum(NumPoints);
+    for (int32 i = 0; i < NumPoints; ++i)
+    {
+        CVPoints[i] = GetLocationAtSplinePoint(i, ESplineCoordinateSpace::Local);
+    }
+
+    Weights.Init(1.0f, CVPoints.Num());
+    GenerateDefaultKnotVector();
+
+}
+
+void UCvCurveComponent::GenerateDefaultKnotVector()
+{
+    const int32 NumCV = CVPoints.Num();
+    const int32 n = NumCV - 1;
+    const int32 m = n + Degree + 1;
+
+    KnotVector.Empty();
+
+    for (int32 i = 0; i <= m; ++i)
+    {
+        if (i < Degree)
+        {
+            KnotVector.Add(0.0f);
+        }
+        else if (i > n)
+        {
+            KnotVector.Add(1.0f);
+        }
+        else
+        {
+            float Value = static_cast<float>(i - Degree) / (n - Degree + 1);
+            KnotVector.Add(Value);
+        }
+    }
+}
+
+FVector UCvCurveComponent::EvaluateAt(float u) const
+{
+    const int32 NumCV = CVPoints.Num();
+    const int32 n = NumCV - 1;
+    const int32 m = n + Degree + 1;
+
+    if (!Evaluator || NumCV < Degree + 1 || KnotVector.Num() < m + 1)
+    {
+        UE_LOG(LogTemp, Error, TEXT("EvaluateAt: Invalid NURBS configuration"));
+        return FVector::ZeroVector;
+    }
+
+    const int32 Span = CvCurveNurbs::FindSpan(KnotVector, Degree, NumCV, u);
+    const FVector4 Pw = Evaluator(CVPoints.GetData(), Weights.GetData(), KnotVector.GetData(), Span, u);
+
+    if (Pw.W < KINDA_SMALL_NUMBER)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("EvaluateAt: Denominator too small at u=%f"), u);
+        return FVector::ZeroVector;
+    }
+
+    return FVector(Pw.X, Pw.Y, Pw.Z) / Pw.W;
+}
+
+
+float UCvCurveComponent::EvaluateSpeedAt(int32 Span, double u) const
+{
+    FVector4 Pw;
+    FVector4 DPw;
+    DerivativeEvaluator(CVPoints.GetData(), Weights.GetData(), KnotVector.GetData(), Span, u, Pw, DPw);
+
+    if (Pw.W < KINDA_SMALL_NUMBER)
+    {
+        return 0.0f;
+    }
+
+    // C' = (A' * w - A * w') / w^2 for the rational curve C = A / w
+    const FVector A(Pw.X, Pw.Y, Pw.Z);
+    const FVector DA(DPw.X, DPw.Y, DPw.Z);
+    return ((DA * Pw.W - A * DPw.W) / (Pw.W * Pw.W)).Size();
+}
+
+double UCvCurveComponent::GaussLegendreSpeed(int32 Span, double U0, double U1) const
+{
+    // 5 point Gauss-Legendre quadrature of |C'(u)| over [U0, U1]
+    static const double Nodes[5] = { -0.9061798459386640, -0.5384693101056831, 0.0, 0.5384693101056831, 0.9061798459386640 };
+    static const double GaussWeights[5] = { 0.2369268850561891, 0.4786286704993665, 0.5688888888888889, 0.4786286704993665, 0.2369268850561891 };
+
+    const double HalfWidth = 0.5 * (U1 - U0);
+    const double Center = 0.5 * (U0 + U1);
+
+    double Sum = 0.0;
+    for (int32 i = 0; i < 5; ++i)
+    {
+        Sum += GaussWeights[i] * EvaluateSpeedAt(Span, Center + HalfWidth * Nodes[i]);
+    }
+    return Sum * HalfWidth;
+}
+
+double UCvCurveComponent::IntegrateSpeed(int32 Span, double U0, double U1, double Whole, int32 Depth) const
+{
+    // Adaptive: split until both halves agree with the whole interval estimate
+    const double Mid = 0.5 * (U0 + U1);
+    const double Left = GaussLegendreSpeed(Span, U0, Mid);
+    const double Right = GaussLegendreSpeed(Span, Mid, U1);
+
+    const double MaxIntegrationError = 1.0e-4;
+    if (Depth >= 12 || FMath::Abs(Left + Right - Whole) <= MaxIntegrationError)
+    {
+        return Left + Right;
+    }
+
+    return IntegrateSpeed(Span, U0, Mid, Left, Depth + 1) + IntegrateSpeed(Span, Mid, U1, Right, Depth + 1);
+}
+
+double UCvCurveComponent::IntegrateSpeed(int32 Span, double U0, double U1) const
+{
+    return IntegrateSpeed(Span, U0, U1, GaussLegendreSpeed(Span, U0, U1), 0);
+}
+
+FArcLengthSample UCvCurveComponent::MakeArcLengthSample(int32 Span, double u, double Distance) const
+{
+    const float Speed = EvaluateSpeedAt(Span, u);
+
+    FArcLengthSample Sample;
+    Sample.U = static_cast<float>(u);
+    Sample.Distance = static_cast<float>(Distance);
+    Sample.DuDs = (Speed > KINDA_SMALL_NUMBER) ? 1.0f / Speed : 0.0f;
+    return Sample;
+}
+
+void UCvCurveComponent::BuildArcLengthTable(float MaxDistanceError)
+{
+    ArcLengthTable.Empty();
+    CurveTotalLength = 0.0f;
+
+    if (CVPoints.Num() < Degree + 1 || KnotVector.Num() == 0 || !DerivativeEvaluator) return;
+
+    const float Tolerance = FMath::Max(MaxDistanceError, KINDA_SMALL_NUMBER);
+    const int32 LastSpan = CVPoints.Num() - 1;
+
+    // Knot spans are the initial intervals; the speed is smooth inside each of them
+    double Total = 0.0;
+    ArcLengthTable.Add(MakeArcLengthSample(Degree, KnotVector[Degree], 0.0));
+
+    for (int32 Span = Degree; Span <= LastSpan; ++Span)
+    {
+        const double U0 = KnotVector[Span];
+        const double U1 = KnotVector[Span + 1];
+        if (U1 - U0 <= KINDA_SMALL_NUMBER)
+        {
+            continue;
+        }
+
+        // The speed may jump at a knot (always for Degree 1 with uneven CV spacing). The previous span ends
+        // with its left-sided slope, so add a second sample at the same distance with this span's slope.
+        const FArcLengthSample Start = MakeArcLengthSample(Span, U0, Total);
+        const FArcLengthSample& Left = ArcLengthTable.Last();
+        if (!FMath::IsNearlyEqual(Left.DuDs, Start.DuDs, 1.0e-4f * FMath::Max(Left.DuDs, Start.DuDs)))
+        {
+            ArcLengthTable.Add(Start);
+        }
+
+        const double SpanLength = IntegrateSpeed(Span, U0, U1);
+        const FArcLengthSample End = MakeArcLengthSample(Span, U1, Total + SpanLength);
+
+        RefineArcLengthInterval(Span, Start, End, Tolerance, 0);
+        ArcLengthTable.Add(End);
+
+        Total += SpanLength;
+    }
+
+    CurveTotalLength = static_cast<float>(Total);
+}
+
+void UCvCurveComponent::RefineArcLengthInterval(int32 Span, const FArcLengthSample A, const FArcLengthSample B, float Tolerance, int32 Depth)
+{
+    const int32 MaxDepth = 16;
+    if (Depth >= MaxDepth)
+    {
+        return;
+    }
+
+    // Probe the Hermite prediction at the quarter points; the distance error is |u_hat - u| * |C'(u)|
+    double PrevU = A.U;
+    double PrevDistance = A.Distance;
+    bool bWithinTolerance = true;
+    FArcLengthSample Mid;
+
+    for (int32 i = 1; i <= 3; ++i)
+    {
+        const double u = FMath::Lerp(static_cast<double>(A.U), static_cast<double>(B.U), i * 0.25);
+        const double Distance = PrevDistance + IntegrateSpeed(Span, PrevU, u);
+
+        const FArcLengthSample Probe = MakeArcLengthSample(Span, u, Distance);
+        if (i == 2)
+        {
+            Mid = Probe;
+        }
+
+        if (bWithinTolerance)
+        {
+            const float PredictedU = CvCurveNurbs::InterpolateArcLength(A, B, Probe.Distance);
+            const float Error = (Probe.DuDs > 0.0f) ? FMath::Abs(PredictedU - Probe.U) / Probe.DuDs : 0.0f;
+            bWithinTolerance = Error <= Tolerance;
+        }
+
+        PrevU = u;
+        PrevDistance = Distance;
+    }
+
+    if (bWithinTolerance)
+    {
+        return;
+    }
+
+    RefineArcLengthInterval(Span, A, Mid, Tolerance, Depth + 1);
+    ArcLengthTable.Add(Mid);
+    RefineArcLengthInterval(Span, Mid, B, Tolerance, Depth + 1);
+}
+
+FTransform UCvCurveComponent::GetTransformAtDistance(float Distance, ESplineCoordinateSpace::Type CoordinateSpace) const
+{
+    const FCvCurveViewPtr View = GetCurveView();
+    if (!View.IsValid() || !View->IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("GetTransformAtDistance: Arc length table is not ready"));
+        return FTransform::Identity;
+    }
+
+    if (CoordinateSpace == ESplineCoordinateSpace::Local)
+    {
+        return View->GetTransformAtDistance(Distance);
+    }
+
+    return View->GetTransformAtDistance(Distance, GetComponentTransform());
+}
+
+float UCvCurveComponent::GetCurveLength() const
+{
+    return CurveTotalLength;
+}
+
+FCvCurveViewPtr UCvCurveComponent::GetCurveView() const
+{
+    FReadScopeLock ReadLock(CurveViewLock);
+    return CurveView;
+}
+
+void UCvCurveComponent::PublishCurveView()
+{
+    FCvCurveViewPtr NewView = MakeShared<FCvCurveView, ESPMode::ThreadSafe>(
+        CVPoints, Weights, KnotVector, Degree, ArcLengthTable, CurveTotalLength);
+
+    FWriteScopeLock WriteLock(CurveViewLock);
+    CurveView = MoveTemp(NewView);
+}
+
+FCvCurveWalker UCvCurveComponent::CreateWalker(float StepDistance, ESplineCoordinateSpace::Type CoordinateSpace) const
+{
+    const FTransform LocalToWorld = (CoordinateSpace == ESplineCoordinateSpace::World) ? GetComponentTransform() : FTransform::Identity;
+    return FCvCurveWalker(CVPoints, Weights, KnotVector, Degree, StepDistance, LocalToWorld);
+}
+
+void UCvCurveComponent::SamplePointsByStepDistance(float StepDistance, TArray<FVector>& OutPoints, ESplineCoordinateSpace::Type CoordinateSpace) const
+{
+    OutPoints.Reset();
+
+    if (CurveTotalLength <= 0.0f || StepDistance <= 0.0f)
+    {
+        return;
+    }
+
+    // CurveTotalLength is in component space; StepDistance is in the requested space
+    const float LengthInSpace = (CoordinateSpace == ESplineCoordinateSpace::World)
+        ? CurveTotalLength * GetComponentTransform().GetMaximumAxisScale()
+        : CurveTotalLength;
+    OutPoints.Reserve(FMath::CeilToInt(LengthInSpace / StepDistance) + KnotVector.Num());
+
+    FCvCurveWalker Walker = CreateWalker(StepDistance, CoordinateSpace);
+    FVector Position;
+    while (Walker.Next(Position))
+    {
+        OutPoints.Add(Position);
+    }
+}
+
+void UCvCurveComponent::UpdateNurbsVisualization_DebugDraw()
+{
+
+    UWorld* World = GetWorld();
+
+    if (!World || CVPoints.Num() < Degree + 1 || KnotVector.Num() == 0) return;
+
+    FlushPersistentDebugLines(World);
+
+    if (World->IsGameWorld())
+    {
+        return;
+    }
+
+    const int32 NumSegments = 1000;
+    const float SegmentLength = CurveTotalLength / NumSegments;
+
+    // Walk in component space so SegmentLength matches CurveTotalLength, then transform each point
+    FCvCurveWalker Walker = CreateWalker(SegmentLength, ESplineCoordinateSpace::Local);
+    const FTransform& ComponentToWorld = GetComponentTransform();
+
+    FVector PrevPos;
+    if (!Walker.Next(PrevPos))
+    {
+        return;
+    }
+    PrevPos = ComponentToWorld.TransformPosition(PrevPos);
+
+    FVector CurrPos;
+    while (Walker.Next(CurrPos))
+    {
+        CurrPos = ComponentToWorld.TransformPosition(CurrPos);
+        DrawDebugLine(
+            World,
+            PrevPos,
+            CurrPos,
+            FColor::White,
+            true,      // persistent (until new construction)
+            0.0f,
+            0,
+            2.0f
+        );
+        PrevPos = CurrPos;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "CvCurveNurbs.h"
+
+namespace CvCurveNurbs
+{
+
+int32 FindSpan(const TArray<float>& KnotVector, const int32 Degree, const int32 NumCV, const float u)
+{
+    const int32 n = NumCV - 1;
+
+    if (u >= KnotVector[n + 1])
+    {
+        return n;
+    }
+    if (u <= KnotVector[Degree])
+    {
+        return Degree;
+    }
+
+    int32 Low = Degree;
+    int32 High = n + 1;
+    int32 Mid = (Low + High) / 2;
+
+    while (u < KnotVector[Mid] || u >= KnotVector[Mid + 1])
+    {
+        if (u < KnotVector[Mid])
+        {
+            High = Mid;
+        }
+        else
+        {
+            Low = Mid;
+        }
+        Mid = (Low + High) / 2;
+    }
+
+    return Mid;
+}
+
+FCvCurveEvaluateFn GetEvaluator(const int32 Degree)
+{
+    static_assert(CvCurveMinDegree == 1 && CvCurveMaxDegree == 5, "Update the evaluator table");
+
+    switch (Degree)
+    {
+    case 1: return &EvaluateHomogeneous<1>;
+    case 2: return &EvaluateHomogeneous<2>;
+    case 3: return &EvaluateHomogeneous<3>;
+    case 4: return &EvaluateHomogeneous<4>;
+    case 5: return &EvaluateHomogeneous<5>;
+    default: return nullptr;
+    }
+}
+
+FCvCurveEvaluateDerivativeFn GetDerivativeEvaluator(const int32 Degree)
+{
+    static_assert(CvCurveMinDegree == 1 && CvCurveMaxDegree == 5, "Update the evaluator table");
+
+    switch (Degree)
+    {
+    case 1: return &EvaluateHomogeneousDerivative<1>;
+    case 2: return &EvaluateHomogeneousDerivative<2>;
+    case 3: return &EvaluateHomogeneousDerivative<3>;
+    case 4: return &EvaluateHomogeneousDerivative<4>;
+    case 5: return &EvaluateHomogeneousDerivative<5>;
+    default: return nullptr;
+    }
+}
+
+float InterpolateArcLength(const FArcLengthSample& A, const FArcLengthSample& B, const float Distance)
+{
+    const float H = B.Distance - A.Distance;
+    if (H <= KINDA_SMALL_NUMBER)
+    {
+        return A.U;
+    }
+
+    // Fritsch-Carlson limiting keeps u(s) monotone inside the interval
+    const float Secant = (B.U - A.U) / H;
+    float DA = A.DuDs;
+    float DB = B.DuDs;
+    if (Secant <= 0.0f)
+    {
+        DA = 0.0f;
+        DB = 0.0f;
+    }
+    else
+    {
+        DA = FMath::Max(DA, 0.0f);
+        DB = FMath::Max(DB, 0.0f);
+
+        const float Alpha = DA / Secant;
+        const float Beta = DB / Secant;
+        const float SumSq = Alpha * Alpha + Beta * Beta;
+        if (SumSq > 9.0f)
+        {
+            const float Tau = 3.0f / FMath::Sqrt(SumSq);
+            DA = Tau * Alpha * Secant;
+            DB = Tau * Beta * Secant;
+        }
+    }
+
+    const float T = FMath::Clamp((Distance - A.Distance) / H, 0.0f, 1.0f);
+    const float T2 = T * T;
+    const float T3 = T2 * T;
+
+    const float H00 = 2.0f * T3 - 3.0f * T2 + 1.0f;
+    const float H10 = T3 - 2.0f * T2 + T;
+    const float H01 = -2.0f * T3 + 3.0f * T2;
+    const float H11 = T3 - T2;
+
+    return H00 * A.U + H10 * H * DA + H01 * B.U + H11 * H * DB;
+}
+
+}
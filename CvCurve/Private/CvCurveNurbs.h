@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CvCurveTypes.h"
+
+// Low level NURBS helpers shared by the component, the walker and the curve snapshot.
+// All functions work on clamped knot vectors built by UCvCurveComponent::GenerateDefaultKnotVector.
+namespace CvCurveNurbs
+{
+    // Returns the knot span index i with U[i] <= u < U[i+1] (clamped to the valid range).
+    int32 FindSpan(const TArray<float>& KnotVector, int32 Degree, int32 NumCV, float u);
+
+    // Returns the degree specialized evaluator, or nullptr if Degree is outside [CvCurveMinDegree, CvCurveMaxDegree].
+    FCvCurveEvaluateFn GetEvaluator(int32 Degree);
+
+    // Same as GetEvaluator for the point + first derivative kernel.
+    FCvCurveEvaluateDerivativeFn GetDerivativeEvaluator(int32 Degree);
+
+    // Parameter at Distance between two arc length samples (monotone cubic Hermite on u(s)).
+    float InterpolateArcLength(const FArcLengthSample& A, const FArcLengthSample& B, float Distance);
+
+    // Computes the P+1 non-zero basis functions of Span at u.
+    // u may lie outside the span; the span polynomial is then extrapolated.
+    // Computed in double so closely spaced samples (forward differencing) stay accurate.
+    template<int32 P>
+    FORCEINLINE void BasisFuns(const float* U, const int32 Span, const double u, double (&OutN)[P + 1])
+    {
+        double Left[P + 1];
+        double Right[P + 1];
+
+        OutN[0] = 1.0;
+
+        for (int32 j = 1; j <= P; ++j)
+        {
+            Left[j] = u - U[Span + 1 - j];
+            Right[j] = U[Span + j] - u;
+
+            double Saved = 0.0;
+            for (int32 r = 0; r < j; ++r)
+            {
+                const double Denom = Right[r + 1] + Left[j - r];
+                const double Temp = (FMath::Abs(Denom) > KINDA_SMALL_NUMBER) ? OutN[r] / Denom : 0.0;
+                OutN[r] = Saved + Right[r + 1] * Temp;
+                Saved = Left[j - r] * Temp;
+            }
+            OutN[j] = Saved;
+        }
+    }
+
+    // Evaluates the homogeneous point (w*x, w*y, w*z, w) of the given span polynomial at u.
+    template<int32 P>
+    FVector4 EvaluateHomogeneous(const FVector* CVPoints, const float* Weights, const float* U, const int32 Span, const double u)
+    {
+        double N[P + 1];
+        BasisFuns<P>(U, Span, u, N);
+
+        FVector4 Result(0.0f, 0.0f, 0.0f, 0.0f);
+
+        for (int32 j = 0; j <= P; ++j)
+        {
+            const int32 Index = Span - P + j;
+            const double NW = N[j] * Weights[Index];
+            const FVector& Point = CVPoints[Index];
+
+            Result.X += NW * Point.X;
+            Result.Y += NW * Point.Y;
+            Result.Z += NW * Point.Z;
+            Result.W += NW;
+        }
+
+        return Result;
+    }
+
+    // Evaluates the homogeneous point and its derivative with respect to u.
+    // N'_{i,p} = p * (N_{i,p-1} / (U[i+p] - U[i]) - N_{i+1,p-1} / (U[i+p+1] - U[i+1]))
+    template<int32 P>
+    void EvaluateHomogeneousDerivative(const FVector* CVPoints, const float* Weights, const float* U, const int32 Span, const double u, FVector4& OutPw, FVector4& OutDPw)
+    {
+        double N[P + 1];
+        BasisFuns<P>(U, Span, u, N);
+
+        double LowerN[P];
+        BasisFuns<P - 1>(U, Span, u, LowerN);
+
+        OutPw = FVector4(0.0f, 0.0f, 0.0f, 0.0f);
+        OutDPw = FVector4(0.0f, 0.0f, 0.0f, 0.0f);
+
+        for (int32 j = 0; j <= P; ++j)
+        {
+            const int32 Index = Span - P + j;
+
+            double DN = 0.0;
+            if (j >= 1)
+            {
+                const double Denom = U[Index + P] - U[Index];
+                DN += (Denom > KINDA_SMALL_NUMBER) ? LowerN[j - 1] / Denom : 0.0;
+            }
+            if (j <= P - 1)
+            {
+                const double Denom = U[Index + P + 1] - U[Index + 1];
+                DN -= (Denom > KINDA_SMALL_NUMBER) ? LowerN[j] / Denom : 0.0;
+            }
+            DN *= P;
+
+            const double W = Weights[Index];
+            const FVector& Point = CVPoints[Index];
+
+            OutPw += FVector4(Point * (N[j] * W), N[j] * W);
+            OutDPw += FVector4(Point * (DN * W), DN * W);
+        }
+    }
+}
@@ -0,0 +1,188 @@
+#include "CvCurveView.h"
+
+#include "CvCurveNurbs.h"
+#include "Algo/BinarySearch.h"
+
+FCvCurveView::FCvCurveView(
+    TArray<FVector> InCVPoints,
+    TArray<float> InWeights,
+    TArray<float> InKnotVector,
+    const int32 InDegree,
+    TArray<FArcLengthSample> InArcLengthTable,
+    const float InCurveTotalLength)
+    : CVPoints(MoveTemp(InCVPoints))
+    , Weights(MoveTemp(InWeights))
+    , KnotVector(MoveTemp(InKnotVector))
+    , Degree(InDegree)
+    , Evaluator(CvCurveNurbs::GetEvaluator(InDegree))
+    , ArcLengthTable(MoveTemp(InArcLengthTable))
+    , CurveTotalLength(InCurveTotalLength)
+{
+}
+
+bool FCvCurveView::IsValid() const
+{
+    const int32 NumCV = CVPoints.Num();
+    return Evaluator != nullptr
+        && NumCV >= Degree + 1
+        && Weights.Num() == NumCV
+        && KnotVector.Num() == NumCV + Degree + 1
+        && ArcLengthTable.Num() >= 2
+        && CurveTotalLength > 0.0f;
+}
+
+FVector FCvCurveView::EvaluateAt(float u) const
+{
+    const int32 NumCV = CVPoints.Num();
+    if (!Evaluator || NumCV < Degree + 1 || KnotVector.Num() < NumCV + Degree + 1)
+    {
+        return FVector::ZeroVector;
+    }
+
+    const int32 Span = CvCurveNurbs::FindSpan(KnotVector, Degree, NumCV, u);
+    const FVector4 Pw = Evaluator(CVPoints.GetData(), Weights.GetData(), KnotVector.GetData(), Span, u);
+
+    if (Pw.W < KINDA_SMALL_NUMBER)
+    {
+        return FVector::ZeroVector;
+    }
+
+    return FVector(Pw.X, Pw.Y, Pw.Z) / Pw.W;
+}
+
+float FCvCurveView::FindUByDistance(float Distance) const
+{
+    if (ArcLengthTable.Num() < 2) return 0.0f;
+
+    // Samples are sorted by distance
+    const int32 Upper = Algo::UpperBoundBy(ArcLengthTable, Distance, &FArcLengthSample::Distance);
+
+    if (Upper <= 0)
+    {
+        return ArcLengthTable[0].U;
+    }
+    if (Upper >= ArcLengthTable.Num())
+    {
+        return ArcLengthTable.Last().U;
+    }
+
+    return CvCurveNurbs::InterpolateArcLength(ArcLengthTable[Upper - 1], ArcLengthTable[Upper], Distance);
+}
+
+FTransform FCvCurveView::GetTransformAtDistance(float Distance) const
+{
+    return GetTransformAtDistance(Distance, FTransform::Identity);
+}
+
+FTransform FCvCurveView::GetTransformAtDistance(float Distance, const FTransform& ComponentToWorld) const
+{
+    if (!IsValid())
+    {
+        return FTransform::Identity;
+    }
+
+    Distance = FMath::Clamp(Distance, 0.0f, CurveTotalLength);
+    float u = FindUByDistance(Distance);
+
+    u = FMath::Clamp(u, KnotVector[Degree], KnotVector.Last() - 0.0001f);
+
+    const float Epsilon = 0.0005f;
+    const float uBack = FMath::Clamp(u - Epsilon, KnotVector[Degree], KnotVector.Last());
+
+    const FVector PosA = EvaluateAt(uBack);
+    const FVector PosB = EvaluateAt(u);
+    FVector Tangent = ComponentToWorld.TransformVector(PosB - PosA).GetSafeNormal();
+
+    if (Tangent.IsNearlyZero())
+    {
+        Tangent = ComponentToWorld.TransformVectorNoScale(FVector::ForwardVector);
+    }
+
+    return FTransform(Tangent.Rotation(), ComponentToWorld.TransformPosition(PosB));
+}
+
+FVector FCvCurveView::GetLocationAtDistance(float Distance, const FTransform& ComponentToWorld) const
+{
+    if (!IsValid())
+    {
+        return ComponentToWorld.GetLocation();
+    }
+
+    Distance = FMath::Clamp(Distance, 0.0f, CurveTotalLength);
+    const float u = FMath::Clamp(FindUByDistance(Distance), KnotVector[Degree], KnotVector.Last());
+
+    return ComponentToWorld.TransformPosition(EvaluateAt(u));
+}
+
+void FCvCurveView::Flatten(float MaxError, const FTransform& ComponentToWorld, TArray<FVector>& OutPoints, TArray<float>& OutDistances) const
+{
+    OutPoints.Reset();
+    OutDistances.Reset();
+
+    if (!IsValid())
+    {
+        return;
+    }
+
+    MaxError = FMath::Max(MaxError, KINDA_SMALL_NUMBER);
+
+    // Start from a few intervals per span so a chord can not skip over a whole S-bend
+    const int32 NumInitial = FMath::Max(4, (CVPoints.Num() - Degree) * 2);
+
+    FVector Prev = GetLocationAtDistance(0.0f, ComponentToWorld);
+    float PrevDistance = 0.0f;
+    OutPoints.Add(Prev);
+    OutDistances.Add(0.0f);
+
+    for (int32 i = 1; i <= NumInitial; ++i)
+    {
+        const float Distance = CurveTotalLength * i / NumInitial;
+        const FVector Curr = GetLocationAtDistance(Distance, ComponentToWorld);
+
+        FlattenInterval(PrevDistance, Prev, Distance, Curr, MaxError, ComponentToWorld, 0, OutPoints, OutDistances);
+
+        Prev = Curr;
+        PrevDistance = Distance;
+    }
+}
+
+void FCvCurveView::FlattenInterval(
+    const float DistanceA,
+    const FVector& A,
+    const float DistanceB,
+    const FVector& B,
+    const float MaxError,
+    const FTransform& ComponentToWorld,
+    const int32 Depth,
+    TArray<FVector>& OutPoints,
+    TArray<float>& OutDistances) const
+{
+    const int32 MaxDepth = 12;
+
+    // Check the quarter points as well as the midpoint, an inflection can put the midpoint on the chord
+    const float DistanceMid = 0.5f * (DistanceA + DistanceB);
+    const FVector Mid = GetLocationAtDistance(DistanceMid, ComponentToWorld);
+
+    bool bFlat = FMath::PointDistToSegment(Mid, A, B) <= MaxError;
+    if (bFlat)
+    {
+        const FVector Q1 = GetLocationAtDistance(0.5f * (DistanceA + DistanceMid), ComponentToWorld);
+        const FVector Q3 = GetLocationAtDistance(0.5f * (DistanceMid + DistanceB), ComponentToWorld);
+        bFlat = FMath::PointDistToSegment(Q1, A, B) <= MaxError && FMath::PointDistToSegment(Q3, A, B) <= MaxError;
+    }
+
+    if (bFlat || Depth >= MaxDepth)
+    {
+        OutPoints.Add(B);
+        OutDistances.Add(DistanceB);
+        return;
+    }
+
+    FlattenInterval(DistanceA, A, DistanceMid, Mid, MaxError, ComponentToWorld, Depth + 1, OutPoints, OutDistances);
+    FlattenInterval(DistanceMid, Mid, DistanceB, B, MaxError, ComponentToWorld, Depth + 1, OutPoints, OutDistances);
+}
+
+FCvCurveWalker FCvCurveView::CreateWalker(float StepDistance, const FTransform& ComponentToWorld) const
+{
+    return FCvCurveWalker(CVPoints, Weights, KnotVector, Degree, StepDistance, ComponentToWorld);
+}
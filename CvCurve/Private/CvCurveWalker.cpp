@@ -0,0 +1,158 @@
+#include "CvCurveWalker.h"
+
+#include "CvCurveNurbs.h"
+
+FCvCurveWalker::FCvCurveWalker(
+    const TArray<FVector>& InCVPoints,
+    const TArray<float>& InWeights,
+    const TArray<float>& InKnotVector,
+    const int32 InDegree,
+    const float InStepDistance,
+    const FTransform& InLocalToWorld,
+    const int32 InReanchorInterval)
+    : CVPoints(InCVPoints)
+    , Weights(InWeights)
+    , KnotVector(InKnotVector)
+    , Degree(InDegree)
+    , StepDistance(FMath::Max(InStepDistance, KINDA_SMALL_NUMBER))
+    , ReanchorInterval(FMath::Max(InReanchorInterval, 1))
+    , LocalToWorld(InLocalToWorld)
+    , bApplyTransform(!InLocalToWorld.Equals(FTransform::Identity))
+{
+    Evaluate = CvCurveNurbs::GetEvaluator(Degree);
+
+    const int32 NumCV = CVPoints.Num();
+    if (!Evaluate || NumCV < Degree + 1 || KnotVector.Num() < NumCV + Degree + 1 || Weights.Num() < NumCV)
+    {
+        return;
+    }
+
+    LastSpan = NumCV - 1;
+    BeginSpan(Degree);
+}
+
+bool FCvCurveWalker::BeginSpan(int32 InSpan)
+{
+    // Skip zero length spans (repeated knots)
+    while (InSpan <= LastSpan && KnotVector[InSpan + 1] - KnotVector[InSpan] <= KINDA_SMALL_NUMBER)
+    {
+        ++InSpan;
+    }
+
+    if (InSpan > LastSpan)
+    {
+        Span = INDEX_NONE;
+        return false;
+    }
+
+    Span = InSpan;
+    SpanStartU = KnotVector[Span];
+    const double SpanEndU = KnotVector[Span + 1];
+
+    // Coarse chord length of the span (in output space) to pick the step count
+    const int32 NumEstimateSegments = 8;
+    float SpanLength = 0.0f;
+    FVector4 PrevW = EvaluateSpan(SpanStartU);
+    for (int32 i = 1; i <= NumEstimateSegments; ++i)
+    {
+        const double u = FMath::Lerp(SpanStartU, SpanEndU, i / static_cast<double>(NumEstimateSegments));
+        const FVector4 CurrW = EvaluateSpan(u);
+        const FVector Chord = FVector(CurrW) / CurrW.W - FVector(PrevW) / PrevW.W;
+        SpanLength += bApplyTransform ? LocalToWorld.TransformVector(Chord).Size() : Chord.Size();
+        PrevW = CurrW;
+    }
+
+    NumSpanSteps = FMath::Max(1, FMath::CeilToInt(SpanLength / StepDistance));
+    StepU = (SpanEndU - SpanStartU) / NumSpanSteps;
+    StepIndex = 0;
+
+    Anchor(SpanStartU);
+    return true;
+}
+
+void FCvCurveWalker::Anchor(const double u)
+{
+    // Sample the span polynomial at u, u+h, ..., u+p*h and build the forward difference table
+    Differences.SetNumUninitialized(Degree + 1);
+    for (int32 k = 0; k <= Degree; ++k)
+    {
+        Differences[k] = EvaluateSpan(u + k * StepU);
+    }
+
+    for (int32 k = 1; k <= Degree; ++k)
+    {
+        for (int32 j = Degree; j >= k; --j)
+        {
+            Differences[j] -= Differences[j - 1];
+        }
+    }
+
+    if (bApplyTransform)
+    {
+        // (w*p, w) -> (w*(M*p + t), w) is linear, so it maps every difference the same way
+        const FVector Translation = LocalToWorld.GetTranslation();
+        for (FVector4& D : Differences)
+        {
+            const FVector V = LocalToWorld.TransformVector(FVector(D.X, D.Y, D.Z)) + D.W * Translation;
+            D = FVector4(V, D.W);
+        }
+    }
+
+    CurrentU = u;
+}
+
+FVector4 FCvCurveWalker::EvaluateSpan(const double u) const
+{
+    return Evaluate(CVPoints.GetData(), Weights.GetData(), KnotVector.GetData(), Span, u);
+}
+
+FVector FCvCurveWalker::ToPosition() const
+{
+    const FVector4& Pw = Differences[0];
+    if (FMath::Abs(Pw.W) < KINDA_SMALL_NUMBER)
+    {
+        return FVector::ZeroVector;
+    }
+    return FVector(Pw.X, Pw.Y, Pw.Z) / Pw.W;
+}
+
+bool FCvCurveWalker::Next(FVector& OutPosition)
+{
+    if (Span == INDEX_NONE)
+    {
+        return false;
+    }
+
+    if (!bEmittedStart)
+    {
+        bEmittedStart = true;
+        OutPosition = ToPosition();
+        return true;
+    }
+
+    if (StepIndex >= NumSpanSteps)
+    {
+        if (!BeginSpan(Span + 1))
+        {
+            return false;
+        }
+    }
+
+    ++StepIndex;
+
+    if (StepIndex % ReanchorInterval == 0 && StepIndex < NumSpanSteps)
+    {
+        Anchor(SpanStartU + StepIndex * StepU);
+    }
+    else
+    {
+        for (int32 k = 0; k < Degree; ++k)
+        {
+            Differences[k] += Differences[k + 1];
+        }
+        CurrentU = SpanStartU + StepIndex * StepU;
+    }
+
+    OutPosition = ToPosition();
+    return true;
+}
@@ -0,0 +1,126 @@
+#include "CvCurveComponent.h"
+
+#include "Algo/BinarySearch.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/Package.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+struct FCvCurveComponentTestAccess
+{
+    // Builds the curve data the way OnRegister does, without needing a world
+    static void Build(UCvCurveComponent& Component, const int32 Degree, const float Tolerance)
+    {
+        Component.Degree = Degree;
+        Component.ArcLengthTolerance = Tolerance;
+        Component.UpdateCurveDataFromSpline();
+        Component.BuildArcLengthTable(Component.ArcLengthTolerance);
+        Component.PublishCurveView();
+    }
+};
+
+namespace
+{
+    // Cumulative chord length over a dense uniform u grid; converges to the true arc length
+    struct FDenseArcLength
+    {
+        TArray<double> U;
+        TArray<double> Distance;
+
+        FDenseArcLength(const FCvCurveView& View, const int32 NumSamples)
+        {
+            U.SetNum(NumSamples + 1);
+            Distance.SetNum(NumSamples + 1);
+
+            FVector Prev = View.EvaluateAt(0.0f);
+            U[0] = 0.0;
+            Distance[0] = 0.0;
+            for (int32 i = 1; i <= NumSamples; ++i)
+            {
+                U[i] = static_cast<double>(i) / NumSamples;
+                const FVector Curr = View.EvaluateAt(static_cast<float>(U[i]));
+                Distance[i] = Distance[i - 1] + FVector::Dist(Prev, Curr);
+                Prev = Curr;
+            }
+        }
+
+        double DistanceAtU(const double u) const
+        {
+            const int32 Upper = FMath::Clamp(Algo::UpperBound(U, u), 1, U.Num() - 1);
+            const double T = (u - U[Upper - 1]) / (U[Upper] - U[Upper - 1]);
+            return FMath::Lerp(Distance[Upper - 1], Distance[Upper], T);
+        }
+    };
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+    FCvCurveArcLengthTest,
+    "CvCurve.ArcLength.MatchesDenseReference",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FCvCurveArcLengthTest::RunTest(const FString& Parameters)
+{
+    // Uneven CV spacing so the curve speed differs from span to span (and jumps at knots for Degree 1)
+    const TArray<FVector> Points = {
+        FVector(0, 0, 0),
+        FVector(50, 0, 0),
+        FVector(400, 300, 0),
+        FVector(420, 320, 50),
+        FVector(900, -200, 0),
+        FVector(1000, -200, 400),
+        FVector(1010, -190, 410),
+    };
+
+    const float Tolerance = 0.1f;
+
+    // The dense reference itself is accurate to well below this
+    const double ReferenceSlack = 0.02;
+
+    for (int32 Degree = CvCurveMinDegree; Degree <= CvCurveMaxDegree; ++Degree)
+    {
+        UCvCurveComponent* Component = NewObject<UCvCurveComponent>(GetTransientPackage());
+        Component->SetSplinePoints(Points, ESplineCoordinateSpace::Local);
+        FCvCurveComponentTestAccess::Build(*Component, Degree, Tolerance);
+
+        const FCvCurveViewPtr View = Component->GetCurveView();
+        if (!TestTrue(FString::Printf(TEXT("Degree %d: view is valid"), Degree), View.IsValid() && View->IsValid()))
+        {
+            continue;
+        }
+
+        const FDenseArcLength Reference(*View, 200000);
+
+        TestNearlyEqual(
+            FString::Printf(TEXT("Degree %d: total length"), Degree),
+            static_cast<double>(View->GetCurveLength()), Reference.Distance.Last(), Tolerance + ReferenceSlack);
+
+        // Distance error of the table inverse: the curve distance at the returned u vs the requested one
+        const int32 NumQueries = 5000;
+        double MaxError = 0.0;
+        float WorstDistance = 0.0f;
+        for (int32 i = 0; i <= NumQueries; ++i)
+        {
+            const float Distance = View->GetCurveLength() * i / NumQueries;
+            const double Error = FMath::Abs(Reference.DistanceAtU(View->FindUByDistance(Distance)) - Distance);
+            if (Error > MaxError)
+            {
+                MaxError = Error;
+                WorstDistance = Distance;
+            }
+        }
+
+        if (MaxError > Tolerance + ReferenceSlack)
+        {
+            AddError(FString::Printf(TEXT("Degree %d: distance error %.4f cm at s=%.2f exceeds tolerance %.4f cm"),
+                Degree, MaxError, WorstDistance, Tolerance));
+        }
+        else
+        {
+            AddInfo(FString::Printf(TEXT("Degree %d: max distance error %.4f cm"), Degree, MaxError));
+        }
+    }
+
+    return true;
+}
+
+#endif
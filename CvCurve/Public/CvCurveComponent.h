@@ -1,68 +1,101 @@
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Components/SplineComponent.h"
-#include "CvCurveComponent.generated.h"
-
-USTRUCT()
-struct FArcLengthSample
-{
-    GENERATED_BODY()
-
-    float U;
-    float Distance;
-};
-
-UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent), DisplayName = "CV Curve")
-class CVCURVE_API UCvCurveComponent : public USplineComponent
-{
-	GENERATED_BODY()
-
-public:	
-	// Sets default values for this component's properties
-	UCvCurveComponent();
-
-
-    UFUNCTION(BlueprintCallable, Category = "CV Curve")
-    FTransform GetTransformAtDistance(float Distance) const;
-
-    UFUNCTION(BlueprintCallable, Category = "CV Curve")
-    float GetCurveLength() const;
-
-public:
-    // Called every frame
-    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
-
-protected:
-	// Called when the game starts
-	virtual void BeginPlay() override;
-	virtual void OnComponentCreated() override;
-	virtual void OnRegister() override;
-
-    TArray<FVector> CVPoints;
-
-    TArray<float> Weights;
-
-    TArray<float> KnotVector;
-
-    int32 Degree = 3;
-
-    TArray<FArcLengthSample> ArcLengthTable;
-
-    float CurveTotalLength = 0.0f;
-
-    void UpdateCurveDataFromSpline();
-
-    FVector EvaluateAt(float u) const;
-
-    void GenerateDefaultKnotVector();
-
-    float BasisFunction(int i, int p, float u) const;
-
-    void UpdateNurbsVisualization_DebugDraw();
-
-    void BuildArcLengthTable(int32 NumSamples);
-
-    float FindUByDistance(float Distance) const;
-	
-};
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/SplineComponent.h"
+#include "CvCurveTypes.h"
+#include "CvCurveView.h"
+#include "CvCurveWalker.h"
+#include "CvCurveComponent.generated.h"
+
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent), DisplayName = "CV Curve")
+class CVCURVE_API UCvCurveComponent : public USplineComponent
+{
+	GENERATED_BODY()
+
+public:	
+	// Sets default values for this component's properties
+	UCvCurveComponent();
+
+
+    // Curve data is kept in component space; World applies the current component transform at query time
+    UFUNCTION(BlueprintCallable, Category = "CV Curve")
+    FTransform GetTransformAtDistance(float Distance, ESplineCoordinateSpace::Type CoordinateSpace = ESplineCoordinateSpace::World) const;
+
+    UFUNCTION(BlueprintCallable, Category = "CV Curve")
+    float GetCurveLength() const;
+
+    // Samples the curve roughly every StepDistance using forward differencing (see FCvCurveWalker)
+    UFUNCTION(BlueprintCallable, Category = "CV Curve")
+    void SamplePointsByStepDistance(float StepDistance, TArray<FVector>& OutPoints, ESplineCoordinateSpace::Type CoordinateSpace = ESplineCoordinateSpace::World) const;
+
+    // Creates a walker over the current curve data. It must not outlive the next OnRegister.
+    FCvCurveWalker CreateWalker(float StepDistance, ESplineCoordinateSpace::Type CoordinateSpace = ESplineCoordinateSpace::World) const;
+
+    // Thread-safe snapshot of the compiled curve in component space; republished on every OnRegister. May be null before the first build.
+    FCvCurveViewPtr GetCurveView() const;
+
+public:
+    // Called every frame
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+	virtual void OnComponentCreated() override;
+	virtual void OnRegister() override;
+
+    TArray<FVector> CVPoints;
+
+    TArray<float> Weights;
+
+    TArray<float> KnotVector;
+
+    // NURBS degree; each value in [1, 5] uses its own compile-time specialized evaluator
+    UPROPERTY(EditAnywhere, Category = "CV Curve", meta = (ClampMin = "1", ClampMax = "5"))
+    int32 Degree = 3;
+
+    // Chosen from Degree once per rebuild
+    FCvCurveEvaluateFn Evaluator = nullptr;
+
+    FCvCurveEvaluateDerivativeFn DerivativeEvaluator = nullptr;
+
+    // Max distance error (cm) of the distance -> parameter table; the sample count adapts to meet it
+    UPROPERTY(EditAnywhere, Category = "CV Curve", meta = (ClampMin = "0.001"))
+    float ArcLengthTolerance = 0.1f;
+
+    TArray<FArcLengthSample> ArcLengthTable;
+
+    float CurveTotalLength = 0.0f;
+
+    void UpdateCurveDataFromSpline();
+
+    FVector EvaluateAt(float u) const;
+
+    void GenerateDefaultKnotVector();
+
+    void UpdateNurbsVisualization_DebugDraw();
+
+    void BuildArcLengthTable(float MaxDistanceError);
+
+    void RefineArcLengthInterval(int32 Span, const FArcLengthSample A, const FArcLengthSample B, float Tolerance, int32 Depth);
+
+    FArcLengthSample MakeArcLengthSample(int32 Span, double u, double Distance) const;
+
+    float EvaluateSpeedAt(int32 Span, double u) const;
+
+    double IntegrateSpeed(int32 Span, double U0, double U1) const;
+
+    double IntegrateSpeed(int32 Span, double U0, double U1, double Whole, int32 Depth) const;
+
+    double GaussLegendreSpeed(int32 Span, double U0, double U1) const;
+
+    void PublishCurveView();
+
+private:
+    friend struct FCvCurveComponentTestAccess;
+
+    mutable FRWLock CurveViewLock;
+
+    FCvCurveViewPtr CurveView;
+	
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CvCurveTypes.generated.h"
+
+// Supported NURBS degrees; each one has its own compile-time specialized evaluator.
+constexpr int32 CvCurveMinDegree = 1;
+constexpr int32 CvCurveMaxDegree = 5;
+
+// Evaluates the homogeneous point (w*x, w*y, w*z, w) of the span polynomial Span at u.
+using FCvCurveEvaluateFn = FVector4 (*)(const FVector* CVPoints, const float* Weights, const float* KnotVector, int32 Span, double u);
+
+// Same as FCvCurveEvaluateFn, also returning the derivative of the homogeneous point with respect to u.
+using FCvCurveEvaluateDerivativeFn = void (*)(const FVector* CVPoints, const float* Weights, const float* KnotVector, int32 Span, double u, FVector4& OutPw, FVector4& OutDPw);
+
+USTRUCT()
+struct FArcLengthSample
+{
+    GENERATED_BODY()
+
+    float U;
+    float Distance;
+
+    // du/ds at this sample from the analytic curve speed; the table interpolates with monotone cubic Hermite.
+    // Where the speed jumps at a knot the table holds two samples at the same distance (left and right slope).
+    float DuDs;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CvCurveTypes.h"
+#include "CvCurveWalker.h"
+
+/**
+ * Immutable snapshot of a compiled CV curve.
+ *
+ * Holds plain copies of the control points, weights, knots and arc length table, so the
+ * queries below can run on any thread (animation workers, task graph jobs, Niagara data
+ * interfaces) while the owning UCvCurveComponent rebuilds its own data on the game thread.
+ * Queries never log; invalid input yields identity / zero results.
+ *
+ * Curve data is stored in component space. The ComponentToWorld overloads apply the owning
+ * component's transform at query time, so moving the owner never invalidates the snapshot.
+ * Distances are measured in component space, like USplineComponent.
+ *
+ * Obtain one with UCvCurveComponent::GetCurveView() and keep the shared pointer alive for
+ * as long as the queries (and any walker created from it) are in use.
+ */
+class CVCURVE_API FCvCurveView
+{
+public:
+    FCvCurveView(
+        TArray<FVector> InCVPoints,
+        TArray<float> InWeights,
+        TArray<float> InKnotVector,
+        int32 InDegree,
+        TArray<FArcLengthSample> InArcLengthTable,
+        float InCurveTotalLength);
+
+    bool IsValid() const;
+
+    float GetCurveLength() const { return CurveTotalLength; }
+
+    FVector EvaluateAt(float u) const;
+
+    float FindUByDistance(float Distance) const;
+
+    FTransform GetTransformAtDistance(float Distance) const;
+
+    FTransform GetTransformAtDistance(float Distance, const FTransform& ComponentToWorld) const;
+
+    FVector GetLocationAtDistance(float Distance, const FTransform& ComponentToWorld = FTransform::Identity) const;
+
+    // Polyline through the curve whose chords stay within MaxError of it (measured after ComponentToWorld).
+    // OutDistances holds the curve distance of each point; both arrays are reset.
+    void Flatten(float MaxError, const FTransform& ComponentToWorld, TArray<FVector>& OutPoints, TArray<float>& OutDistances) const;
+
+    // The walker references this view's arrays; keep the view alive while walking.
+    FCvCurveWalker CreateWalker(float StepDistance, const FTransform& ComponentToWorld = FTransform::Identity) const;
+
+private:
+    const TArray<FVector> CVPoints;
+
+    const TArray<float> Weights;
+
+    const TArray<float> KnotVector;
+
+    const int32 Degree;
+
+    const FCvCurveEvaluateFn Evaluator;
+
+    const TArray<FArcLengthSample> ArcLengthTable;
+
+    const float CurveTotalLength;
+
+    void FlattenInterval(float DistanceA, const FVector& A, float DistanceB, const FVector& B, float MaxError, const FTransform& ComponentToWorld, int32 Depth, TArray<FVector>& OutPoints, TArray<float>& OutDistances) const;
+};
+
+using FCvCurveViewPtr = TSharedPtr<const FCvCurveView, ESPMode::ThreadSafe>;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CvCurveTypes.h"
+
+/**
+ * Walks a CV curve in (approximately) fixed distance steps using forward differencing.
+ *
+ * Each knot span is a polynomial of degree Degree in homogeneous space, so after anchoring
+ * a difference table at the start of a span every further step costs Degree vector adds
+ * and one divide. The table is re-anchored from an exact evaluation every ReanchorInterval
+ * steps to keep floating point drift bounded.
+ *
+ * Steps are uniform in the curve parameter within a span; the step count of each span is
+ * chosen from its estimated length so the emitted points are roughly StepDistance apart.
+ *
+ * Control points are in component space. When LocalToWorld is given, the anchored difference
+ * table is transformed once (the map is linear in homogeneous coordinates), so world space
+ * stepping costs the same as local stepping.
+ *
+ * The walker references the curve arrays it was created from and must not outlive them.
+ */
+class CVCURVE_API FCvCurveWalker
+{
+public:
+    FCvCurveWalker(
+        const TArray<FVector>& InCVPoints,
+        const TArray<float>& InWeights,
+        const TArray<float>& InKnotVector,
+        int32 InDegree,
+        float InStepDistance,
+        const FTransform& InLocalToWorld = FTransform::Identity,
+        int32 InReanchorInterval = 16);
+
+    /** Emits the next point. The first call returns the curve start, the last one the curve end. */
+    bool Next(FVector& OutPosition);
+
+    /** Curve parameter of the point returned by the last call to Next. */
+    float GetParameter() const { return static_cast<float>(CurrentU); }
+
+private:
+    const TArray<FVector>& CVPoints;
+    const TArray<float>& Weights;
+    const TArray<float>& KnotVector;
+
+    int32 Degree = 3;
+    FCvCurveEvaluateFn Evaluate = nullptr;
+    float StepDistance = 1.0f;
+    int32 ReanchorInterval = 16;
+
+    FTransform LocalToWorld;
+    bool bApplyTransform = false;
+
+    int32 Span = INDEX_NONE;
+    int32 LastSpan = INDEX_NONE;
+    int32 StepIndex = 0;
+    int32 NumSpanSteps = 0;
+    double SpanStartU = 0.0;
+    double StepU = 0.0;
+    double CurrentU = 0.0;
+    bool bEmittedStart = false;
+
+    /** Differences[0] is the current homogeneous point, Differences[k] its k-th forward difference. */
+    TArray<FVector4, TInlineAllocator<8>> Differences;
+
+    bool BeginSpan(int32 InSpan);
+    void Anchor(double u);
+    FVector4 EvaluateSpan(double u) const;
+    FVector ToPosition() const;
+};
@@ -1,11 +1,509 @@
 #include "CylinderConvexTraceComponent.h"
 
 #include "PhysicsEngine/AggregateGeom.h"
+#include "PhysicsEngine/ConvexElem.h"
+#include "Physics/PhysicsInterfaceCore.h"
+#include "Chaos/Convex.h"
+#include "Chaos/ImplicitObjectScaled.h"
+#include "Chaos/GeometryQueries.h"
+#include "Chaos/GJK.h"
+#include "Chaos/CastingUtilities.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "ActorTagIndexSubsystem.h"
+#include "CvCurveComponent.h"
+#include "CvCurveView.h"
+#include "SceneQueryRecorder.h"
 #include "Engine/World.h"
+#include "Async/ParallelFor.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace
+{
+    using FScaledPrismGeometry = Chaos::TImplicitObjectScaled<Chaos::FConvex>;
+
+    /** GJK で直接扱える凸のシェイプか（三角形メッシュ・ハイトフィールド等は false） */
+    bool IsConvexGeometry(const Chaos::FImplicitObject& Geometry)
+    {
+        const Chaos::EImplicitObjectType InnerType = Chaos::GetInnerType(Geometry.GetType());
+        return InnerType == Chaos::ImplicitObjectType::Sphere
+            || InnerType == Chaos::ImplicitObjectType::Box
+            || InnerType == Chaos::ImplicitObjectType::Capsule
+            || InnerType == Chaos::ImplicitObjectType::Convex;
+    }
+
+    /**
+     * Target に QueryGeometry をスイープ（結果はワールド空間）。
+     * FCylinder は SweepQuery に渡せない（相手の型ごとの分岐が全て実体化され、三角形メッシュ・ハイトフィールドには
+     * FCylinder 版が無い）ので、凸の相手は GJK で直接判定し、凸でない相手は同じ寸法の多角柱 NonConvexStandIn で
+     * 代用する（それも無ければ判定しない）。
+     */
+    template<typename TQueryGeometry>
+    bool SweepQueryGeometry(
+        const Chaos::FImplicitObject& Target,
+        const Chaos::FRigidTransform3& TargetTM,
+        const TQueryGeometry& QueryGeometry,
+        const FScaledPrismGeometry* NonConvexStandIn,
+        const Chaos::FRigidTransform3& StartTM,
+        const Chaos::FVec3& Dir,
+        const Chaos::FReal Length,
+        Chaos::FReal& OutTime,
+        Chaos::FVec3& OutPosition,
+        Chaos::FVec3& OutNormal,
+        int32& OutFaceIndex
+    )
+    {
+        if constexpr (std::is_same_v<TQueryGeometry, Chaos::FCylinder>)
+        {
+            if (!IsConvexGeometry(Target))
+            {
+                return NonConvexStandIn
+                    && SweepQueryGeometry(Target, TargetTM, *NonConvexStandIn, nullptr, StartTM, Dir, Length, OutTime, OutPosition, OutNormal, OutFaceIndex);
+            }
+
+            bool bHit = false;
+            OutFaceIndex = INDEX_NONE;
+            Chaos::Utilities::CastHelper(Target, TargetTM, [&](const auto& TargetDowncast, const Chaos::FRigidTransform3& FullTM)
+            {
+                // 相手のローカル空間でのレイキャスト（SweepQuery の凸同士と同じ）
+                const Chaos::FRigidTransform3 BToATM = StartTM.GetRelativeTransform(FullTM);
+                const Chaos::FVec3 LocalDir = FullTM.InverseTransformVectorNoScale(Dir);
+
+                Chaos::FVec3 LocalPosition(0.0);
+                Chaos::FVec3 LocalNormal(0.0);
+                bHit = Chaos::GJKRaycast2<Chaos::FReal>(TargetDowncast, QueryGeometry, BToATM, LocalDir, Length,
+                    OutTime, LocalPosition, LocalNormal, 0.0, false);
+                if (bHit)
+                {
+                    OutPosition = FullTM.TransformPosition(LocalPosition);
+                    OutNormal = FullTM.TransformVectorNoScale(LocalNormal);
+                }
+            });
+            return bHit;
+        }
+        else
+        {
+            Chaos::FVec3 FaceNormal(0.0);
+            return Chaos::SweepQuery(Target, TargetTM, QueryGeometry, StartTM, Dir, Length,
+                OutTime, OutPosition, OutNormal, OutFaceIndex, FaceNormal, 0.0, false);
+        }
+    }
+
+    /**
+     * Pose に置いた QueryGeometry が Target と重なるか（OutMTD があれば押し出し量と向きも）。
+     * FCylinder の扱いは SweepQueryGeometry と同じ（OverlapQuery には渡さない）。
+     */
+    template<typename TQueryGeometry>
+    bool OverlapQueryGeometry(
+        const Chaos::FImplicitObject& Target,
+        const Chaos::FRigidTransform3& TargetTM,
+        const TQueryGeometry& QueryGeometry,
+        const FScaledPrismGeometry* NonConvexStandIn,
+        const Chaos::FRigidTransform3& Pose,
+        Chaos::FMTDInfo* OutMTD
+    )
+    {
+        if constexpr (std::is_same_v<TQueryGeometry, Chaos::FCylinder>)
+        {
+            if (!IsConvexGeometry(Target))
+            {
+                return NonConvexStandIn && OverlapQueryGeometry(Target, TargetTM, *NonConvexStandIn, nullptr, Pose, OutMTD);
+            }
+
+            bool bOverlap = false;
+            Chaos::Utilities::CastHelper(Target, TargetTM, [&](const auto& TargetDowncast, const Chaos::FRigidTransform3& FullTM)
+            {
+                const Chaos::FRigidTransform3 BToATM = Pose.GetRelativeTransform(FullTM);
+                bOverlap = Chaos::GJKIntersection<Chaos::FReal>(TargetDowncast, QueryGeometry, BToATM, 0.0);
+                if (!bOverlap || !OutMTD)
+                {
+                    return;
+                }
+
+                Chaos::FReal Penetration = 0.0;
+                Chaos::FVec3 ClosestA(0.0);
+                Chaos::FVec3 ClosestB(0.0);
+                Chaos::FVec3 LocalNormal(0.0);
+                int32 ClosestVertexIndexA = INDEX_NONE;
+                int32 ClosestVertexIndexB = INDEX_NONE;
+                if (Chaos::GJKPenetration(TargetDowncast, QueryGeometry, BToATM, Penetration, ClosestA, ClosestB, LocalNormal,
+                    ClosestVertexIndexA, ClosestVertexIndexB))
+                {
+                    OutMTD->Penetration = Penetration;
+                    OutMTD->Normal = FullTM.TransformVectorNoScale(LocalNormal);
+                }
+            });
+            return bOverlap;
+        }
+        else
+        {
+            return Chaos::OverlapQuery(Target, TargetTM, QueryGeometry, Pose, 0.0, OutMTD);
+        }
+    }
+
+    /**
+     * Body のクエリシェイプ全てに QueryGeometry をスイープし、最も手前のヒットの時刻・位置・法線を OutHit に書く。
+     * Actor/Component 等の識別情報は呼び出し側で設定しておくこと。
+     */
+    template<typename TQueryGeometry>
+    bool SweepGeometryAgainstBody(
+        const FBodyInstance& BodyInstance,
+        const TQueryGeometry& QueryGeometry,
+        const FVector& StartCenter,
+        const FVector& EndCenter,
+        const FQuat& Rotation,
+        FHitResult& OutHit,
+        const FScaledPrismGeometry* NonConvexStandIn = nullptr
+    )
+    {
+        if (!BodyInstance.IsValidBodyInstance())
+        {
+            return false;
+        }
+
+        const FVector Delta = EndCenter - StartCenter;
+        const float Length = Delta.Size();
+        if (Length <= KINDA_SMALL_NUMBER)
+        {
+            return false;
+        }
+        const FVector Dir = Delta / Length;
+        const Chaos::FRigidTransform3 StartTM(StartCenter, Rotation);
+
+        bool bHit = false;
+        Chaos::FReal BestTime = TNumericLimits<Chaos::FReal>::Max();
+        Chaos::FVec3 BestPosition(0.0);
+        Chaos::FVec3 BestNormal(0.0);
+        int32 BestFaceIndex = INDEX_NONE;
+
+        FPhysicsCommand::ExecuteRead(BodyInstance.GetPhysicsActorHandle(), [&](const FPhysicsActorHandle& Actor)
+        {
+            TArray<FPhysicsShapeHandle> Shapes;
+            FPhysicsInterface::GetAllShapes_AssumedLocked(Actor, Shapes);
+
+            for (const FPhysicsShapeHandle& Shape : Shapes)
+            {
+                if (!FPhysicsInterface::IsQueryShape(Shape))
+                {
+                    continue;
+                }
+
+                Chaos::FReal Time = 0.0;
+                Chaos::FVec3 Position(0.0);
+                Chaos::FVec3 Normal(0.0);
+                int32 FaceIndex = INDEX_NONE;
+
+                const bool bShapeHit = SweepQueryGeometry(
+                    Shape.GetGeometry(),
+                    FPhysicsInterface::GetTransform(Shape),
+                    QueryGeometry,
+                    NonConvexStandIn,
+                    StartTM,
+                    Chaos::FVec3(Dir),
+                    Chaos::FReal(Length),
+                    Time,
+                    Position,
+                    Normal,
+                    FaceIndex
+                );
+
+                if (bShapeHit && Time < BestTime)
+                {
+                    bHit = true;
+                    BestTime = Time;
+                    BestPosition = Position;
+                    BestNormal = Normal;
+                    BestFaceIndex = FaceIndex;
+                }
+            }
+        });
+
+        if (!bHit)
+        {
+            return false;
+        }
+
+        OutHit.Time = FMath::Clamp(static_cast<float>(BestTime / Length), 0.0f, 1.0f);
+        OutHit.Distance = static_cast<float>(BestTime);
+        OutHit.Location = StartCenter + Dir * OutHit.Distance;
+        OutHit.bStartPenetrating = BestTime <= 0.0;
+        OutHit.PenetrationDepth = 0.0f;
+        OutHit.FaceIndex = BestFaceIndex;
+
+        if (!OutHit.bStartPenetrating)
+        {
+            OutHit.ImpactPoint = FVector(BestPosition);
+            OutHit.ImpactNormal = FVector(BestNormal).GetSafeNormal();
+            OutHit.Normal = OutHit.ImpactNormal;
+        }
+
+        OutHit.TraceStart = StartCenter;
+        OutHit.TraceEnd = EndCenter;
+        return true;
+    }
+
+    /**
+     * Pose に置いた QueryGeometry が Body のクエリシェイプと重なるか。
+     * bComputeMTD なら最も深いシェイプの押し出し量と向き（QueryGeometry を押し出す向き）も返す。
+     * FCylinder は凸でないシェイプと判定できないので、そのシェイプは NonConvexStandIn で判定する。
+     */
+    template<typename TQueryGeometry>
+    bool OverlapGeometryWithBody(
+        const FBodyInstance& BodyInstance,
+        const TQueryGeometry& QueryGeometry,
+        const FTransform& Pose,
+        const bool bComputeMTD,
+        float& OutDepth,
+        FVector& OutDirection,
+        const FScaledPrismGeometry* NonConvexStandIn = nullptr
+    )
+    {
+        if (!BodyInstance.IsValidBodyInstance())
+        {
+            return false;
+        }
+
+        bool bOverlap = false;
+        OutDepth = 0.0f;
+        OutDirection = FVector::ZeroVector;
+
+        FPhysicsCommand::ExecuteRead(BodyInstance.GetPhysicsActorHandle(), [&](const FPhysicsActorHandle& Actor)
+        {
+            TArray<FPhysicsShapeHandle> Shapes;
+            FPhysicsInterface::GetAllShapes_AssumedLocked(Actor, Shapes);
+
+            for (const FPhysicsShapeHandle& Shape : Shapes)
+            {
+                if (!FPhysicsInterface::IsQueryShape(Shape))
+                {
+                    continue;
+                }
+
+                Chaos::FMTDInfo MTD;
+                const bool bShapeOverlap = OverlapQueryGeometry(Shape.GetGeometry(), FPhysicsInterface::GetTransform(Shape),
+                    QueryGeometry, NonConvexStandIn, Pose, bComputeMTD ? &MTD : nullptr);
+                if (!bShapeOverlap)
+                {
+                    continue;
+                }
+
+                bOverlap = true;
+                if (!bComputeMTD)
+                {
+                    return; // 重なりの有無だけで十分
+                }
+
+                if (MTD.Penetration > OutDepth)
+                {
+                    OutDepth = static_cast<float>(MTD.Penetration);
+                    OutDirection = FVector(MTD.Normal).GetSafeNormal();
+                }
+            }
+        });
+
+        return bOverlap;
+    }
+
+    /** 開始・終了姿勢の間の姿勢（位置は線形、回転は Slerp） */
+    FTransform InterpolatePose(const FTransform& StartPose, const FTransform& EndPose, const float T)
+    {
+        return FTransform(
+            FQuat::Slerp(StartPose.GetRotation(), EndPose.GetRotation(), T).GetNormalized(),
+            FMath::Lerp(StartPose.GetLocation(), EndPose.GetLocation(), T));
+    }
+
+    /**
+     * 回転しながら動く QueryGeometry を、Body のクエリシェイプに対して保守的前進法（Conservative Advancement）で判定。
+     *
+     * 各反復で GJK の距離 d を求め、姿勢補間の間にどの点も動き得る最大量（並進量 + 回転角 × 外接半径）で割った
+     * 分だけ t を進めます。すり抜けずに最初の接触時刻へ収束します。
+     * 反復の上限までに詰め切れなかった場合（すれすれに通り過ぎる場合など）は、残りの区間を回転を分割した
+     * 短いスイープで判定します（接触していないのにヒットにはしない）。
+     * 凸でないシェイプ（三角形メッシュ・ハイトフィールド）は最初から分割したスイープで判定します
+     * （並進の無い区間は両端の姿勢の重なり。FCylinder はこの相手に使えないので NonConvexStandIn で判定）。
+     */
+    template<typename TQueryGeometry>
+    bool AdvanceGeometryAgainstBody(
+        const FBodyInstance& BodyInstance,
+        const TQueryGeometry& QueryGeometry,
+        const float BoundingRadius,
+        const FTransform& StartPose,
+        const FTransform& EndPose,
+        FHitResult& OutHit,
+        const FScaledPrismGeometry* NonConvexStandIn = nullptr
+    )
+    {
+        if (!BodyInstance.IsValidBodyInstance())
+        {
+            return false;
+        }
+
+        const int32 MaxIterations = 32;
+        const float ContactTolerance = 0.05f;
+        const float MaxSubstepAngle = FMath::DegreesToRadians(10.0f);
+
+        const float Translation = FVector::Dist(StartPose.GetLocation(), EndPose.GetLocation());
+        const float Angle = StartPose.GetRotation().AngularDistance(EndPose.GetRotation());
+
+        // t に対する任意の点の移動量の上限
+        const float MotionBound = Translation + Angle * BoundingRadius;
+
+        bool bHit = false;
+        float BestTime = TNumericLimits<float>::Max();
+        FVector BestPoint = FVector::ZeroVector;
+        FVector BestNormal = FVector::ZeroVector;
+
+        const auto ReportHit = [&](const float Time, const FVector& Point, const FVector& Normal)
+        {
+            if (Time < BestTime)
+            {
+                bHit = true;
+                BestTime = Time;
+                BestPoint = Point;
+                BestNormal = Normal;
+            }
+        };
+
+        // [TStart, 1] を回転を刻んだスイープで判定（各区間は中間の回転で固定）。最初に当たった区間で終える
+        const auto SweepSubsteps = [&](const Chaos::FImplicitObject& Geometry, const FTransform& ShapeTM, const float TStart)
+        {
+            const int32 NumSubsteps = FMath::Clamp(FMath::CeilToInt(Angle * (1.0f - TStart) / MaxSubstepAngle), 1, 32);
+            for (int32 Step = 0; Step < NumSubsteps; ++Step)
+            {
+                const float T0 = FMath::Lerp(TStart, 1.0f, static_cast<float>(Step) / NumSubsteps);
+                const float T1 = FMath::Lerp(TStart, 1.0f, static_cast<float>(Step + 1) / NumSubsteps);
+                const FVector P0 = FMath::Lerp(StartPose.GetLocation(), EndPose.GetLocation(), T0);
+                const FVector P1 = FMath::Lerp(StartPose.GetLocation(), EndPose.GetLocation(), T1);
+                const FQuat R = InterpolatePose(StartPose, EndPose, 0.5f * (T0 + T1)).GetRotation();
+
+                const Chaos::FVec3 Delta = P1 - P0;
+                const Chaos::FReal Length = Delta.Size();
+
+                if (Length <= KINDA_SMALL_NUMBER)
+                {
+                    // その場での回転はスイープできないので、区間の両端の姿勢の重なりで判定し、
+                    // 重なれば区間の始まりを接触とみなす（接触点は分からないので円柱の中心）
+                    for (const float TEnd : { T0, T1 })
+                    {
+                        const FTransform Pose = InterpolatePose(StartPose, EndPose, TEnd);
+                        Chaos::FMTDInfo MTD;
+                        if (OverlapQueryGeometry(Geometry, ShapeTM, QueryGeometry, NonConvexStandIn, Pose, &MTD))
+                        {
+                            ReportHit(T0, Pose.GetLocation(), FVector(MTD.Normal));
+                            return;
+                        }
+                    }
+                    continue;
+                }
+
+                Chaos::FReal Time = 0.0;
+                Chaos::FVec3 Position(0.0);
+                Chaos::FVec3 Normal(0.0);
+                int32 FaceIndex = INDEX_NONE;
+
+                if (SweepQueryGeometry(Geometry, ShapeTM, QueryGeometry, NonConvexStandIn, Chaos::FRigidTransform3(P0, R), Delta / Length, Length,
+                    Time, Position, Normal, FaceIndex))
+                {
+                    ReportHit(FMath::Lerp(T0, T1, static_cast<float>(Time / Length)), FVector(Position), FVector(Normal));
+                    return;
+                }
+            }
+        };
+
+        FPhysicsCommand::ExecuteRead(BodyInstance.GetPhysicsActorHandle(), [&](const FPhysicsActorHandle& Actor)
+        {
+            TArray<FPhysicsShapeHandle> Shapes;
+            FPhysicsInterface::GetAllShapes_AssumedLocked(Actor, Shapes);
+
+            for (const FPhysicsShapeHandle& Shape : Shapes)
+            {
+                if (!FPhysicsInterface::IsQueryShape(Shape))
+                {
+                    continue;
+                }
+
+                const Chaos::FImplicitObject& Geometry = Shape.GetGeometry();
+                const FTransform ShapeTM = FPhysicsInterface::GetTransform(Shape);
+
+                if (!IsConvexGeometry(Geometry))
+                {
+                    SweepSubsteps(Geometry, ShapeTM, 0.0f);
+                    continue;
+                }
+
+                // 反復の上限で詰め切れなかった時の再開位置（そこまでは離れていたことが保証される）
+                TOptional<float> ResumeTime;
+
+                Chaos::Utilities::CastHelper(Geometry, ShapeTM, [&](const auto& ConvexA, const Chaos::FRigidTransform3& FullTM)
+                {
+                    float T = 0.0f;
+                    Chaos::FVec3 NearestA(0.0);
+                    Chaos::FVec3 NormalA(0.0);
+
+                    for (int32 Iter = 0; Iter < MaxIterations; ++Iter)
+                    {
+                        const FTransform Pose = InterpolatePose(StartPose, EndPose, T);
+                        const Chaos::FRigidTransform3 BToATM = Pose.GetRelativeTransform(FullTM);
+
+                        Chaos::FReal Distance = 0.0;
+                        Chaos::FVec3 NearestB(0.0);
+                        const Chaos::EGJKDistanceResult Result = Chaos::GJKDistance<Chaos::FReal>(ConvexA, QueryGeometry, BToATM, Distance, NearestA, NearestB, NormalA);
+
+                        if (Result != Chaos::EGJKDistanceResult::Separated || Distance <= ContactTolerance)
+                        {
+                            // 接触した時刻（位置・法線は最後の距離計算のもの）
+                            ReportHit(T, FullTM.TransformPosition(NearestA), FullTM.TransformVectorNoScale(NormalA));
+                            return;
+                        }
+
+                        if (MotionBound <= KINDA_SMALL_NUMBER)
+                        {
+                            return;
+                        }
+
+                        // この距離より動くまでは接触しない
+                        T += static_cast<float>(Distance) / MotionBound;
+                        if (T > 1.0f)
+                        {
+                            return;
+                        }
+                    }
+
+                    ResumeTime = T;
+                });
+
+                if (ResumeTime.IsSet())
+                {
+                    SweepSubsteps(Geometry, ShapeTM, ResumeTime.GetValue());
+                }
+            }
+        });
+
+        if (!bHit)
+        {
+            return false;
+        }
+
+        const FTransform HitPose = InterpolatePose(StartPose, EndPose, BestTime);
+
+        OutHit.Time = BestTime;
+        OutHit.Distance = Translation * BestTime;
+        OutHit.Location = HitPose.GetLocation();
+        OutHit.bStartPenetrating = BestTime <= 0.0f;
+        OutHit.PenetrationDepth = 0.0f;
+        OutHit.ImpactPoint = BestPoint;
+        OutHit.ImpactNormal = BestNormal.GetSafeNormal();
+        OutHit.Normal = OutHit.ImpactNormal;
+        OutHit.TraceStart = StartPose.GetLocation();
+        OutHit.TraceEnd = EndPose.GetLocation();
+        return true;
+    }
+}
 
 UCylinderConvexTraceComponent::UCylinderConvexTraceComponent()
 {
-    PrimaryComponentTick.bCanEverTick = false;
+    // バッチ結果の受け渡しにだけ使う（保留中のバッチがある間だけ有効化）
+    PrimaryComponentTick.bCanEverTick = true;
+    PrimaryComponentTick.bStartWithTickEnabled = false;
 
     SetMobility(EComponentMobility::Movable);
 
@@ -32,73 +530,102 @@ void UCylinderConvexTraceComponent::OnRegister()
     {
         BuildUnitPrismConvex(NumSides);
     }
+
+    UpdateDeviationPrismShapes();
 }
 
-void UCylinderConvexTraceComponent::EnsureBodySetup()
+#if WITH_EDITOR
+void UCylinderConvexTraceComponent::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
 {
-    if (BodySetup)
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    if (PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(UCylinderConvexTraceComponent, MaxDeviationCm))
     {
-        return;
+        UpdateDeviationPrismShapes();
     }
-
-    BodySetup = NewObject<UBodySetup>(this, NAME_None, RF_Transient);
-
-    BodySetup->bGenerateMirroredCollision = false;
-    BodySetup->bDoubleSidedGeometry = false;
-
-    // Simple(Convex) をクエリに使う
-    BodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseSimpleAsComplex;
 }
+#endif
 
-UBodySetup* UCylinderConvexTraceComponent::GetBodySetup()
+void UCylinderConvexTraceComponent::SetMaxDeviationCm(const float InMaxDeviationCm)
 {
-    EnsureBodySetup();
-    return BodySetup;
+    MaxDeviationCm = FMath::Max(InMaxDeviationCm, 0.0f);
+    UpdateDeviationPrismShapes();
 }
 
-void UCylinderConvexTraceComponent::BuildUnitPrismConvex(const int32 InNumSides)
+void UCylinderConvexTraceComponent::UpdateDeviationPrismShapes()
 {
-    EnsureBodySetup();
-
-    const int32 ClampedSides = FMath::Clamp(InNumSides, 3, 128);
+    check(IsInGameThread());
 
-    // 既に同じ角数で構築済みなら何もしない
-    if (CachedNumSides == ClampedSides && BodySetup->AggGeom.ConvexElems.Num() == 1)
+    if (MaxDeviationCm <= 0.0f)
     {
+        DeviationPrismShapes.Reset();
         return;
     }
 
-    CachedNumSides = ClampedSides;
+    // どの角数が選ばれるかは半径次第なので、全プリセットを用意しておく（クエリ側では追加しない）。
+    // 共有キャッシュは弱参照なので、ここで保持してトレースごとにクックし直さない
+    for (const int32 Sides : FCylinderPrismShapeCache::GetPresetNumSides())
+    {
+        TSharedPtr<FCylinderPrismShape>& Shape = DeviationPrismShapes.FindOrAdd(Sides);
+        if (!Shape.IsValid())
+        {
+            Shape = FCylinderPrismShapeCache::FindOrCreate(Sides);
+        }
+    }
+}
 
-    BodySetup->AggGeom.ConvexElems.Reset();
+const FCylinderPrismShape* UCylinderConvexTraceComponent::ResolvePrismShape(const FCylinderTraceQueryContext& Context, const float Radius)
+{
+    if (Context.MaxDeviation <= 0.0f)
+    {
+        return Context.Shape.Get();
+    }
 
-    // 単位多角柱：
-    // - 半径 1（XY）
-    // - 高さ 1（Z: -0.5..+0.5）
-    const float Radius = 1.0f;
-    const float HalfHeight = 0.5f;
+    const int32 Sides = FCylinderPrismShapeCache::SelectNumSidesForDeviation(Radius, Context.MaxDeviation);
+    const TSharedPtr<FCylinderPrismShape>* Shape = Context.DeviationShapes.Find(Sides);
+    return Shape ? Shape->Get() : Context.Shape.Get();
+}
 
-    TArray<FVector> Verts;
-    Verts.Reserve(ClampedSides * 2);
+bool UCylinderConvexTraceComponent::MakeScaledPrism(const FCylinderTraceQueryContext& Context, const FVector& Scale, TOptional<FScaledPrismGeometry>& OutScaledPrism)
+{
+    const FCylinderPrismShape* Shape = ResolvePrismShape(Context, Scale.X);
+    if (!Shape || !Shape->IsCooked())
+    {
+        return false;
+    }
 
-    for (int32 i = 0; i < ClampedSides; ++i)
+    const auto& ConvexMesh = Shape->GetBodySetup()->AggGeom.ConvexElems[0].GetChaosConvexMesh();
+    if (!ConvexMesh)
     {
-        const float A = (2.0f * PI) * (static_cast<float>(i) / static_cast<float>(ClampedSides));
-        const float X = FMath::Cos(A) * Radius;
-        const float Y = FMath::Sin(A) * Radius;
+        return false;
+    }
+
+    OutScaledPrism.Emplace(ConvexMesh, Scale);
+    return true;
+}
 
-        Verts.Add(FVector(X, Y, -HalfHeight)); // bottom
-        Verts.Add(FVector(X, Y, +HalfHeight)); // top
+UBodySetup* UCylinderConvexTraceComponent::GetBodySetup()
+{
+    // 物理ステート生成から呼ばれ得るので、ここでは取得のみ（RecreatePhysicsState はしない）
+    if (!PrismShape.IsValid())
+    {
+        PrismShape = FCylinderPrismShapeCache::FindOrCreate(NumSides);
     }
+    return PrismShape->GetBodySetup();
+}
+
+void UCylinderConvexTraceComponent::BuildUnitPrismConvex(const int32 InNumSides)
+{
+    const int32 ClampedSides = FCylinderPrismShapeCache::ClampNumSides(InNumSides);
 
-    FKConvexElem Convex;
-    Convex.VertexData = MoveTemp(Verts);
-    Convex.UpdateElemBox();
-    BodySetup->AggGeom.ConvexElems.Add(MoveTemp(Convex));
+    // 既に同じ角数の形状を保持しているなら何もしない
+    if (PrismShape.IsValid() && PrismShape->GetNumSides() == ClampedSides)
+    {
+        return;
+    }
 
-    // 物理データを作り直し（クック）
-    BodySetup->InvalidatePhysicsData();
-    BodySetup->CreatePhysicsMeshes();
+    // 同じ角数のクック済み形状があれば共有、無ければここで1回だけクック
+    PrismShape = FCylinderPrismShapeCache::FindOrCreate(ClampedSides);
 
     // BodyInstance更新
     RecreatePhysicsState();
@@ -130,7 +657,7 @@ FBoxSphereBounds UCylinderConvexTraceComponent::CalcBounds(const FTransform& Loc
     return FBoxSphereBounds(FBox(Origin - Extents, Origin + Extents));
 }
 
-bool UCylinderConvexTraceComponent::ShouldAcceptActorByTag(const AActor* Actor, const FName Tag, const EActorTagFilterMode Mode) const
+bool UCylinderConvexTraceComponent::ShouldAcceptActorByTag(const AActor* Actor, const FName Tag, const EActorTagFilterMode Mode)
 {
     if (Tag.IsNone())
     {
@@ -145,10 +672,80 @@ bool UCylinderConvexTraceComponent::ShouldAcceptActorByTag(const AActor* Actor,
         return (Mode == EActorTagFilterMode::Exclude);
     }
 
+    // 索引は Tags の直接書き換えに追従しないので、最終判定は常に Actor 自身のタグで行う
     const bool bHasTag = Actor->ActorHasTag(Tag);
     return (Mode == EActorTagFilterMode::Include) ? bHasTag : !bHasTag;
 }
 
+bool UCylinderConvexTraceComponent::MakeTagSnapshot(const UWorld* World, const FName Tag, const int32 MaxActors, FCylinderTraceTagSnapshot& OutSnapshot)
+{
+    // 索引は BeginPlay で初期登録されるため、それ以前（エディタワールド等）は使わない
+    if (Tag.IsNone() || !World || !World->HasBegunPlay())
+    {
+        return false;
+    }
+
+    const UActorTagIndexSubsystem* TagIndex = World->GetSubsystem<UActorTagIndexSubsystem>();
+    if (!TagIndex)
+    {
+        return false;
+    }
+
+    // 境界の計算と Exclude の無視リストは対象数に比例してトレースごとに掛かるので、多いタグでは索引を使わない
+    if (TagIndex->GetNumActorsWithTag(Tag) > MaxActors)
+    {
+        return false;
+    }
+
+    TArray<AActor*> Actors;
+    TagIndex->GetActorsWithTag(Tag, Actors);
+
+    OutSnapshot.Actors.Reset();
+    OutSnapshot.Bounds.Reset();
+    OutSnapshot.Actors.Reserve(Actors.Num());
+    OutSnapshot.Bounds.Reserve(Actors.Num());
+
+    for (const AActor* Actor : Actors)
+    {
+        // 索引の登録後に Tags から外されたもの（直接の書き換え）は対象にしない
+        if (!Actor->ActorHasTag(Tag))
+        {
+            continue;
+        }
+
+        OutSnapshot.Actors.Add(Actor);
+
+        const FBox Bounds = Actor->GetComponentsBoundingBox();
+        if (Bounds.IsValid)
+        {
+            OutSnapshot.Bounds.Add(Bounds);
+        }
+    }
+
+    return true;
+}
+
+bool UCylinderConvexTraceComponent::IsTagSnapshotOutsideSweep(
+    const FCylinderTraceTagSnapshot& Snapshot,
+    const FVector& Start,
+    const FVector& End,
+    const float Radius,
+    const float HalfLength
+)
+{
+    const float Extent = FMath::Sqrt(Radius * Radius + HalfLength * HalfLength);
+    const FBox SweptBox = FBox(Start, Start).ExpandBy(Extent) + FBox(End, End).ExpandBy(Extent);
+
+    for (const FBox& Bounds : Snapshot.Bounds)
+    {
+        if (Bounds.Intersect(SweptBox))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool UCylinderConvexTraceComponent::SweepOnce(
     const FVector& StartCenter,
     const FVector& EndCenter,
@@ -189,8 +786,62 @@ bool UCylinderConvexTraceComponent::CylinderTraceFromTransform(
     FHitResult& OutHit
 )
 {
-    // 形状未構築なら構築（OnRegister無効時や初期化順対策）
+    if (!FSceneQueryRecorder::IsRecording())
+    {
+        return CylinderTraceFromTransformImpl(Transform, TraceDistance, Radius, HalfLength, Tag, FilterMode, OutHit);
+    }
+
+    // 記録中のみ計測（入力・設定・結果・所要時間）
+    const double StartSeconds = FPlatformTime::Seconds();
+    const bool bHit = CylinderTraceFromTransformImpl(Transform, TraceDistance, Radius, HalfLength, Tag, FilterMode, OutHit);
+    const double Duration = FPlatformTime::Seconds() - StartSeconds;
+
+    FCylinderTraceRecord Record;
+    Record.Transform = Transform;
+    Record.TraceDistance = TraceDistance;
+    Record.Radius = Radius;
+    Record.HalfLength = HalfLength;
+    Record.Tag = Tag.IsNone() ? FString() : Tag.ToString();
+    Record.FilterMode = static_cast<uint8>(FilterMode);
+    Record.NumSides = NumSides;
+    Record.MaxFilterIterations = MaxFilterIterations;
+    Record.ShapeMode = static_cast<uint8>(ShapeMode);
+    Record.bSinglePassTagFilter = bSinglePassTagFilter;
+    Record.MaxDeviationCm = MaxDeviationCm;
+    Record.CollisionObjectType = static_cast<uint8>(GetCollisionObjectType());
+    Record.ChannelResponses.SetNum(ECC_MAX);
+    for (int32 Channel = 0; Channel < ECC_MAX; ++Channel)
+    {
+        Record.ChannelResponses[Channel] = static_cast<uint8>(GetCollisionResponseToChannel(static_cast<ECollisionChannel>(Channel)));
+    }
+    Record.bHit = bHit;
+    Record.HitDistance = bHit ? OutHit.Distance : 0.0f;
+    Record.ImpactPoint = bHit ? FVector(OutHit.ImpactPoint) : FVector::ZeroVector;
+    FSceneQueryRecorder::RecordCylinderTrace(Record, Duration);
+
+    return bHit;
+}
+
+bool UCylinderConvexTraceComponent::CylinderTraceFromTransformImpl(
+    const FTransform& Transform,
+    const float TraceDistance,
+    const float Radius,
+    const float HalfLength,
+    const FName Tag,
+    const EActorTagFilterMode FilterMode,
+    FHitResult& OutHit
+)
+{
+    // 形状未構築なら構築（OnRegister無効時や初期化順対策。MaxDeviationCm を直接書き換えた場合も）
     BuildUnitPrismConvex(NumSides);
+    UpdateDeviationPrismShapes();
+
+    // 半径で形状を選ぶモードもコンポーネントの形状を差し替えない（物理ステートの作り直しを避ける）
+    if (bSinglePassTagFilter || ShapeMode == ECylinderTraceShapeMode::ExactCylinder || MaxDeviationCm > 0.0f)
+    {
+        // 1回のマルチヒットスイープで完結（コンポーネントは動かさない）
+        return CylinderTraceStateless(Transform, TraceDistance, Radius, HalfLength, Tag, FilterMode, OutHit);
+    }
 
     // 寸法（単位多角柱をスケール）
     SetWorldScale3D(FVector(Radius, Radius, 2.0f * HalfLength));
@@ -203,6 +854,27 @@ bool UCylinderConvexTraceComponent::CylinderTraceFromTransform(
     // Move ignore の状態をこの関数内に閉じる
     ClearMoveIgnoreActors();
 
+    // タグ索引があれば、Include は経路上に対象が無いときスイープ自体を省略、Exclude は対象を最初から無視
+    FCylinderTraceTagSnapshot TagSnapshotStorage;
+    const FCylinderTraceTagSnapshot* TagSnapshot = MakeTagSnapshot(GetWorld(), Tag, MaxTagSnapshotActors, TagSnapshotStorage) ? &TagSnapshotStorage : nullptr;
+    if (TagSnapshot)
+    {
+        if (FilterMode == EActorTagFilterMode::Include)
+        {
+            if (IsTagSnapshotOutsideSweep(*TagSnapshot, Start, End, Radius, HalfLength))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            for (const AActor* Actor : TagSnapshot->Actors)
+            {
+                IgnoreActorWhenMoving(const_cast<AActor*>(Actor), true);
+            }
+        }
+    }
+
     // 反復探索（フィルタ不一致のActorを一時的に無視して次候補へ）
     const int32 IterMax = FMath::Clamp(MaxFilterIterations, 1, 256);
 
@@ -243,4 +915,1379 @@ bool UCylinderConvexTraceComponent::CylinderTraceFromTransform(
 
     ClearMoveIgnoreActors();
     return false;
+}
+
+FCylinderTraceQueryContext UCylinderConvexTraceComponent::MakeQueryContext(const TArray<FName>& Tags, const TConstArrayView<float> Radii) const
+{
+    FCylinderTraceQueryContext Context;
+    Context.World = GetWorld();
+    Context.Shape = PrismShape;
+    Context.Channel = GetCollisionObjectType();
+    Context.MaxFilterIterations = FMath::Clamp(MaxFilterIterations, 1, 256);
+    Context.bSinglePassTagFilter = bSinglePassTagFilter;
+    Context.ShapeMode = ShapeMode;
+    Context.MaxDeviation = MaxDeviationCm;
+
+    // 使う半径の角数だけ載せる（形状は UpdateDeviationPrismShapes で用意済み。無い角数は Shape で代用）
+    if (MaxDeviationCm > 0.0f)
+    {
+        for (const float Radius : Radii)
+        {
+            const int32 Sides = FCylinderPrismShapeCache::SelectNumSidesForDeviation(Radius, MaxDeviationCm);
+            if (const TSharedPtr<FCylinderPrismShape>* Shape = DeviationPrismShapes.Find(Sides))
+            {
+                Context.DeviationShapes.Add(Sides, *Shape);
+            }
+        }
+    }
+
+    // MoveComponent と同じ条件（Owner無視・このコンポーネントの応答設定）
+    FComponentQueryParams QueryParams(SCENE_QUERY_STAT(CylinderTraceStateless), GetOwner());
+    InitSweepCollisionParams(QueryParams, Context.ResponseParams);
+    Context.QueryParams = QueryParams;
+
+    // 索引・Actor の一覧はゲームスレッドでだけ読む（ワーカーからの CylinderTraceStateless では絞り込みなし）
+    if (!IsInGameThread())
+    {
+        return Context;
+    }
+
+    for (const FName Tag : Tags)
+    {
+        if (Tag.IsNone() || Context.TagSnapshots.Contains(Tag))
+        {
+            continue;
+        }
+
+        FCylinderTraceTagSnapshot Snapshot;
+        if (MakeTagSnapshot(Context.World, Tag, MaxTagSnapshotActors, Snapshot))
+        {
+            Context.TagSnapshots.Add(Tag, MoveTemp(Snapshot));
+        }
+    }
+
+    return Context;
+}
+
+void UCylinderConvexTraceComponent::SweepConvexMulti(
+    const FCylinderTraceQueryContext& Context,
+    const FVector& StartCenter,
+    const FVector& EndCenter,
+    const FQuat& Rotation,
+    const FVector& Scale,
+    const FCollisionQueryParams& QueryParams,
+    const FCollisionResponseParams& ResponseParams,
+    TArray<FHitResult>& OutHits
+)
+{
+    OutHits.Reset();
+
+    const FCylinderPrismShape* Shape = ResolvePrismShape(Context, Scale.X);
+    if (!Context.World || !Shape || !Shape->IsCooked())
+    {
+        return;
+    }
+
+    // クック済みの単位多角柱をそのまま使い、寸法はスケール付きImplicitで与える（コンポーネントのScaleは触らない）
+    const auto& ConvexMesh = Shape->GetBodySetup()->AggGeom.ConvexElems[0].GetChaosConvexMesh();
+    if (!ConvexMesh)
+    {
+        return;
+    }
+
+    const Chaos::TImplicitObjectScaled<Chaos::FConvex> ScaledConvex(ConvexMesh, Scale);
+
+    FPhysicsInterface::GeomSweepMulti(
+        Context.World,
+        static_cast<const FPhysicsGeometry&>(ScaledConvex),
+        Rotation,
+        OutHits,
+        StartCenter,
+        EndCenter,
+        Context.Channel,
+        QueryParams,
+        ResponseParams
+    );
+
+    OutHits.StableSort([](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; });
+}
+
+bool UCylinderConvexTraceComponent::SweepConvexOnce(
+    const FCylinderTraceQueryContext& Context,
+    const FVector& StartCenter,
+    const FVector& EndCenter,
+    const FQuat& Rotation,
+    const FVector& Scale,
+    const FCollisionQueryParams& QueryParams,
+    const FCollisionResponseParams& ResponseParams,
+    FHitResult& OutHit
+)
+{
+    TArray<FHitResult> Hits;
+    SweepConvexMulti(Context, StartCenter, EndCenter, Rotation, Scale, QueryParams, ResponseParams, Hits);
+
+    // Multiの結果は Touch 群 + Block（あれば）
+    for (const FHitResult& Hit : Hits)
+    {
+        if (Hit.bBlockingHit)
+        {
+            OutHit = Hit;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UCylinderConvexTraceComponent::IsBlockingResponse(const FCylinderTraceQueryContext& Context, const FHitResult& Hit)
+{
+    const UPrimitiveComponent* HitComponent = Hit.GetComponent();
+    if (!HitComponent)
+    {
+        return false;
+    }
+
+    // 双方の応答の弱い方が実際の応答
+    const ECollisionResponse Ours = Context.ResponseParams.CollisionResponse.GetResponse(HitComponent->GetCollisionObjectType());
+    const ECollisionResponse Theirs = HitComponent->GetCollisionResponseToChannel(Context.Channel);
+    return FMath::Min(Ours, Theirs) == ECR_Block;
+}
+
+void UCylinderConvexTraceComponent::SweepExactCylinderMulti(
+    const FCylinderTraceQueryContext& Context,
+    const FVector& StartCenter,
+    const FVector& EndCenter,
+    const FQuat& Rotation,
+    const float Radius,
+    const float HalfLength,
+    const FCollisionQueryParams& QueryParams,
+    TArray<FHitResult>& OutHits
+)
+{
+    TArray<FHitResult> Candidates;
+    GatherExactCylinderCandidates(Context, StartCenter, EndCenter, Rotation, Radius, HalfLength, QueryParams, Candidates);
+    RefineExactCylinderCandidates(Context, Candidates, StartCenter, EndCenter, Rotation, Radius, HalfLength, OutHits);
+}
+
+void UCylinderConvexTraceComponent::GatherExactCylinderCandidates(
+    const FCylinderTraceQueryContext& Context,
+    const FVector& StartCenter,
+    const FVector& EndCenter,
+    const FQuat& Rotation,
+    const float Radius,
+    const float HalfLength,
+    const FCollisionQueryParams& QueryParams,
+    TArray<FHitResult>& OutCandidates
+)
+{
+    OutCandidates.Reset();
+
+    if (!Context.World || Radius <= 0.0f || HalfLength <= 0.0f)
+    {
+        return;
+    }
+
+    // 円柱を包む外接カプセル（半高さは半球を含む）で全応答を Overlap 扱いにして候補収集
+    FCollisionResponseParams TouchAllParams = Context.ResponseParams;
+    TouchAllParams.CollisionResponse.ReplaceChannels(ECR_Block, ECR_Overlap);
+
+    FPhysicsInterface::GeomSweepMulti(
+        Context.World,
+        FCollisionShape::MakeCapsule(Radius, HalfLength + Radius),
+        Rotation,
+        OutCandidates,
+        StartCenter,
+        EndCenter,
+        Context.Channel,
+        QueryParams,
+        TouchAllParams
+    );
+}
+
+void UCylinderConvexTraceComponent::RefineExactCylinderCandidates(
+    const FCylinderTraceQueryContext& Context,
+    const TArray<FHitResult>& Candidates,
+    const FVector& StartCenter,
+    const FVector& EndCenter,
+    const FQuat& Rotation,
+    const float Radius,
+    const float HalfLength,
+    TArray<FHitResult>& OutHits
+)
+{
+    OutHits.Reset();
+
+    if (Radius <= 0.0f || HalfLength <= 0.0f)
+    {
+        return;
+    }
+
+    // 円柱はローカルZ軸（単位多角柱と同じ向き）
+    const Chaos::FCylinder Cylinder(Chaos::FVec3(0.0, 0.0, -HalfLength), Chaos::FVec3(0.0, 0.0, HalfLength), Radius);
+
+    // 凸でない相手（三角形メッシュ・ハイトフィールド）用の代用形状。形状が未構築ならそれらの相手は判定しない
+    TOptional<FScaledPrismGeometry> StandIn;
+    MakeScaledPrism(Context, FVector(Radius, Radius, 2.0f * HalfLength), StandIn);
+
+    // 候補はシェイプごとに返るが、円柱での判定はボディの全シェイプをまとめて行うのでボディごとに1回
+    TSet<TTuple<const UPrimitiveComponent*, int32, FName>> SweptBodies;
+    SweptBodies.Reserve(Candidates.Num());
+
+    for (const FHitResult& Candidate : Candidates)
+    {
+        bool bAlreadySwept = false;
+        SweptBodies.Add(MakeTuple(Candidate.GetComponent(), Candidate.Item, Candidate.BoneName), &bAlreadySwept);
+        if (bAlreadySwept)
+        {
+            continue;
+        }
+
+        FHitResult Hit;
+        if (SweepExactCylinderAgainst(Candidate, Cylinder, StandIn.GetPtrOrNull(), StartCenter, EndCenter, Rotation, Hit))
+        {
+            OutHits.Add(Hit);
+        }
+    }
+
+    OutHits.StableSort([](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; });
+}
+
+bool UCylinderConvexTraceComponent::SweepExactCylinderAgainst(
+    const FHitResult& Candidate,
+    const Chaos::FCylinder& Cylinder,
+    const FScaledPrismGeometry* NonConvexStandIn,
+    const FVector& StartCenter,
+    const FVector& EndCenter,
+    const FQuat& Rotation,
+    FHitResult& OutHit
+)
+{
+    const UPrimitiveComponent* HitComponent = Candidate.GetComponent();
+    const FBodyInstance* BodyInstance = HitComponent ? HitComponent->GetBodyInstance(Candidate.BoneName, true, Candidate.Item) : nullptr;
+    if (!BodyInstance)
+    {
+        return false;
+    }
+
+    // 候補（カプセルのヒット）から Actor/Component 等を引き継ぎ、円柱の結果で上書き
+    OutHit = Candidate;
+    return SweepGeometryAgainstBody(*BodyInstance, Cylinder, StartCenter, EndCenter, Rotation, OutHit, NonConvexStandIn);
+}
+
+void UCylinderConvexTraceComponent::CollectPathHits(
+    const FCylinderTraceQueryContext& Context,
+    const FVector& StartCenter,
+    const FVector& EndCenter,
+    const FQuat& Rotation,
+    const FVector& Scale,
+    const FCollisionQueryParams& QueryParams,
+    TArray<FHitResult>& OutHits
+)
+{
+    if (Context.ShapeMode == ECylinderTraceShapeMode::ExactCylinder)
+    {
+        SweepExactCylinderMulti(Context, StartCenter, EndCenter, Rotation, Scale.X, 0.5f * Scale.Z, QueryParams, OutHits);
+        return;
+    }
+
+    // 全チャンネルを Overlap 扱いでスイープすると、ブロック相手も含めて経路上の全ヒットが時間順で返る
+    FCollisionResponseParams TouchAllParams = Context.ResponseParams;
+    TouchAllParams.CollisionResponse.ReplaceChannels(ECR_Block, ECR_Overlap);
+
+    SweepConvexMulti(Context, StartCenter, EndCenter, Rotation, Scale, QueryParams, TouchAllParams, OutHits);
+}
+
+bool UCylinderConvexTraceComponent::SweepSinglePassFiltered(
+    const FCylinderTraceQueryContext& Context,
+    const FVector& StartCenter,
+    const FVector& EndCenter,
+    const FQuat& Rotation,
+    const FVector& Scale,
+    const FCollisionQueryParams& QueryParams,
+    const FName Tag,
+    const EActorTagFilterMode FilterMode,
+    FHitResult& OutHit
+)
+{
+    TArray<FHitResult> Hits;
+    CollectPathHits(Context, StartCenter, EndCenter, Rotation, Scale, QueryParams, Hits);
+
+    return SelectFirstAcceptedHit(Context, Hits, Tag, FilterMode, OutHit);
+}
+
+bool UCylinderConvexTraceComponent::SelectFirstAcceptedHit(
+    const FCylinderTraceQueryContext& Context,
+    const TArray<FHitResult>& Hits,
+    const FName Tag,
+    const EActorTagFilterMode FilterMode,
+    FHitResult& OutHit
+)
+{
+    for (const FHitResult& Hit : Hits)
+    {
+        if (!IsBlockingResponse(Context, Hit))
+        {
+            continue;
+        }
+
+        if (!ShouldAcceptActorByTag(Hit.GetActor(), Tag, FilterMode))
+        {
+            continue;
+        }
+
+        OutHit = Hit;
+        OutHit.bBlockingHit = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool UCylinderConvexTraceComponent::ApplyTagPrefilter(
+    const FCylinderTraceQueryContext& Context,
+    const FCylinderTraceRequest& Request,
+    const FVector& StartCenter,
+    const FVector& EndCenter,
+    FCollisionQueryParams& QueryParams
+)
+{
+    const FCylinderTraceTagSnapshot* TagSnapshot = Request.Tag.IsNone() ? nullptr : Context.TagSnapshots.Find(Request.Tag);
+    if (!TagSnapshot)
+    {
+        return true;
+    }
+
+    // タグ索引: Include は経路上に対象が無ければ即終了、Exclude は対象をブロードフェーズから外す
+    if (Request.FilterMode == EActorTagFilterMode::Include)
+    {
+        return !IsTagSnapshotOutsideSweep(*TagSnapshot, StartCenter, EndCenter, Request.Radius, Request.HalfLength);
+    }
+
+    for (const AActor* Actor : TagSnapshot->Actors)
+    {
+        QueryParams.AddIgnoredActor(Actor);
+    }
+    return true;
+}
+
+bool UCylinderConvexTraceComponent::TraceWithContext(
+    const FCylinderTraceQueryContext& Context,
+    const FCylinderTraceRequest& Request,
+    FHitResult& OutHit
+)
+{
+    const FVector Scale(Request.Radius, Request.Radius, 2.0f * Request.HalfLength);
+
+    const FVector Start = Request.Transform.GetLocation();
+    const FVector Dir = -Request.Transform.GetUnitAxis(EAxis::Z); // ローカルZ-方向
+    const FVector End = Start + Dir * Request.TraceDistance;
+    const FQuat Rot = Request.Transform.GetRotation();
+
+    FCollisionQueryParams QueryParams = Context.QueryParams;
+    if (!ApplyTagPrefilter(Context, Request, Start, End, QueryParams))
+    {
+        return false;
+    }
+
+    // 円柱モードは反復スイープ版を持たない（候補収集が1回で済むため）
+    if (Context.bSinglePassTagFilter || Context.ShapeMode == ECylinderTraceShapeMode::ExactCylinder)
+    {
+        return SweepSinglePassFiltered(Context, Start, End, Rot, Scale, QueryParams, Request.Tag, Request.FilterMode, OutHit);
+    }
+
+    // 反復探索（フィルタ不一致のActorはクエリパラメータ側で無視して次候補へ）
+    for (int32 Iter = 0; Iter < Context.MaxFilterIterations; ++Iter)
+    {
+        FHitResult Hit;
+        if (!SweepConvexOnce(Context, Start, End, Rot, Scale, QueryParams, Context.ResponseParams, Hit))
+        {
+            return false;
+        }
+
+        AActor* HitActor = Hit.GetActor();
+
+        if (ShouldAcceptActorByTag(HitActor, Request.Tag, Request.FilterMode))
+        {
+            OutHit = Hit;
+            return true;
+        }
+
+        if (!HitActor)
+        {
+            // Actorが取れない不一致ヒットは無視リストに入れられないため諦める
+            return false;
+        }
+
+        QueryParams.AddIgnoredActor(HitActor);
+    }
+
+    return false;
+}
+
+bool UCylinderConvexTraceComponent::CylinderTraceStateless(
+    const FTransform& Transform,
+    const float TraceDistance,
+    const float Radius,
+    const float HalfLength,
+    const FName Tag,
+    const EActorTagFilterMode FilterMode,
+    FHitResult& OutHit
+) const
+{
+    FCylinderTraceRequest Request;
+    Request.Transform = Transform;
+    Request.TraceDistance = TraceDistance;
+    Request.Radius = Radius;
+    Request.HalfLength = HalfLength;
+    Request.Tag = Tag;
+    Request.FilterMode = FilterMode;
+
+    return TraceWithContext(MakeQueryContext({ Tag }, { Radius }), Request, OutHit);
+}
+
+bool UCylinderConvexTraceComponent::CylinderTraceMulti(
+    const FTransform& Transform,
+    const float TraceDistance,
+    const float Radius,
+    const float HalfLength,
+    const FName Tag,
+    const EActorTagFilterMode FilterMode,
+    TArray<FHitResult>& OutHits,
+    const int32 MaxHits
+) const
+{
+    OutHits.Reset();
+
+    FCylinderTraceRequest Request;
+    Request.Transform = Transform;
+    Request.TraceDistance = TraceDistance;
+    Request.Radius = Radius;
+    Request.HalfLength = HalfLength;
+    Request.Tag = Tag;
+    Request.FilterMode = FilterMode;
+
+    const FCylinderTraceQueryContext Context = MakeQueryContext({ Tag }, { Radius });
+
+    const FVector Scale(Radius, Radius, 2.0f * HalfLength);
+    const FVector Start = Transform.GetLocation();
+    const FVector End = Start - Transform.GetUnitAxis(EAxis::Z) * TraceDistance; // ローカルZ-方向
+    const FQuat Rot = Transform.GetRotation();
+
+    FCollisionQueryParams QueryParams = Context.QueryParams;
+    if (!ApplyTagPrefilter(Context, Request, Start, End, QueryParams))
+    {
+        return false;
+    }
+
+    // 1回のスイープで全候補を時間順に得て、タグで絞るだけ（無視リストを育てての再スイープはしない）
+    TArray<FHitResult> Hits;
+    CollectPathHits(Context, Start, End, Rot, Scale, QueryParams, Hits);
+
+    // Prism のスイープはシェイプごとに返るので、ボディごとに最も手前の1件にまとめる（ExactCylinder と同じ単位）
+    TSet<TTuple<const UPrimitiveComponent*, int32, FName>> ReportedBodies;
+    ReportedBodies.Reserve(Hits.Num());
+
+    for (const FHitResult& Hit : Hits)
+    {
+        if (!ShouldAcceptActorByTag(Hit.GetActor(), Tag, FilterMode))
+        {
+            continue;
+        }
+
+        bool bAlreadyReported = false;
+        ReportedBodies.Add(MakeTuple(Hit.GetComponent(), Hit.Item, Hit.BoneName), &bAlreadyReported);
+        if (bAlreadyReported)
+        {
+            continue;
+        }
+
+        FHitResult& Accepted = OutHits.Add_GetRef(Hit);
+        Accepted.bBlockingHit = IsBlockingResponse(Context, Hit);
+
+        if (MaxHits > 0 && OutHits.Num() >= MaxHits)
+        {
+            break;
+        }
+    }
+
+    return OutHits.Num() > 0;
+}
+
+bool UCylinderConvexTraceComponent::CylinderOverlap(
+    const FTransform& Transform,
+    const float Radius,
+    const float HalfLength,
+    const FName Tag,
+    const EActorTagFilterMode FilterMode,
+    TArray<FCylinderOverlapResult>& OutOverlaps,
+    const bool bComputePenetration
+) const
+{
+    OutOverlaps.Reset();
+
+    const FCylinderTraceQueryContext Context = MakeQueryContext({ Tag }, { Radius });
+    if (!Context.World)
+    {
+        return false;
+    }
+
+    FCylinderTraceRequest Request;
+    Request.Transform = Transform;
+    Request.Radius = Radius;
+    Request.HalfLength = HalfLength;
+    Request.Tag = Tag;
+    Request.FilterMode = FilterMode;
+
+    const FVector Location = Transform.GetLocation();
+    const FQuat Rot = Transform.GetRotation();
+    const FTransform Pose(Rot, Location);
+
+    FCollisionQueryParams QueryParams = Context.QueryParams;
+    if (!ApplyTagPrefilter(Context, Request, Location, Location, QueryParams))
+    {
+        return false;
+    }
+
+    const FVector Scale(Radius, Radius, 2.0f * HalfLength);
+    TOptional<FScaledPrismGeometry> ScaledConvex;
+    TOptional<Chaos::FCylinder> Cylinder;
+    TArray<FOverlapResult> Overlaps;
+
+    if (Context.ShapeMode == ECylinderTraceShapeMode::ExactCylinder)
+    {
+        Cylinder.Emplace(Chaos::FVec3(0.0, 0.0, -HalfLength), Chaos::FVec3(0.0, 0.0, HalfLength), Radius);
+
+        // 三角形メッシュ・ハイトフィールドの候補は円柱で判定できないので、同じ寸法の多角柱で判定する
+        MakeScaledPrism(Context, Scale, ScaledConvex);
+
+        // 外接カプセルで候補を集め、下で円柱と重なるものだけ残す
+        FPhysicsInterface::GeomOverlapMulti(
+            Context.World,
+            FCollisionShape::MakeCapsule(Radius, HalfLength + Radius),
+            Location,
+            Rot,
+            Overlaps,
+            Context.Channel,
+            QueryParams,
+            Context.ResponseParams,
+            FCollisionObjectQueryParams::DefaultObjectQueryParam
+        );
+    }
+    else
+    {
+        if (!MakeScaledPrism(Context, Scale, ScaledConvex))
+        {
+            return false;
+        }
+
+        // キャッシュ済みConvexでそのままオーバーラップ（結果は確定）
+        FPhysicsInterface::GeomOverlapMulti(
+            Context.World,
+            static_cast<const FPhysicsGeometry&>(ScaledConvex.GetValue()),
+            Location,
+            Rot,
+            Overlaps,
+            Context.Channel,
+            QueryParams,
+            Context.ResponseParams,
+            FCollisionObjectQueryParams::DefaultObjectQueryParam
+        );
+    }
+
+    for (const FOverlapResult& Overlap : Overlaps)
+    {
+        UPrimitiveComponent* Component = Overlap.GetComponent();
+        if (!Component)
+        {
+            continue;
+        }
+
+        AActor* OverlapActor = Overlap.GetActor();
+        if (!ShouldAcceptActorByTag(OverlapActor, Tag, FilterMode))
+        {
+            continue;
+        }
+
+        float Depth = 0.0f;
+        FVector Direction = FVector::ZeroVector;
+        bool bHasPenetration = false;
+
+        // ExactCylinder は候補の確定、Prism は押し出し量が必要な時だけナローフェーズ
+        if (Cylinder.IsSet() || bComputePenetration)
+        {
+            const FBodyInstance* BodyInstance = Component->GetBodyInstance(NAME_None, true, Overlap.ItemIndex);
+            if (!BodyInstance)
+            {
+                continue;
+            }
+
+            const bool bOverlap = Cylinder.IsSet()
+                ? OverlapGeometryWithBody(*BodyInstance, Cylinder.GetValue(), Pose, bComputePenetration, Depth, Direction, ScaledConvex.GetPtrOrNull())
+                : OverlapGeometryWithBody(*BodyInstance, ScaledConvex.GetValue(), Pose, bComputePenetration, Depth, Direction);
+
+            if (!bOverlap && Cylinder.IsSet())
+            {
+                continue;
+            }
+            bHasPenetration = bOverlap && bComputePenetration;
+        }
+
+        FCylinderOverlapResult& Result = OutOverlaps.AddDefaulted_GetRef();
+        Result.Component = Component;
+        Result.Actor = OverlapActor;
+        Result.ItemIndex = Overlap.ItemIndex;
+        Result.bBlocking = Overlap.bBlockingHit;
+        Result.bHasPenetration = bHasPenetration;
+        Result.PenetrationDepth = Depth;
+        Result.PenetrationDirection = Direction;
+    }
+
+    return OutOverlaps.Num() > 0;
+}
+
+bool UCylinderConvexTraceComponent::CylinderTraceInterpolated(
+    const FTransform& StartTransform,
+    const FTransform& EndTransform,
+    const float Radius,
+    const float HalfLength,
+    const FName Tag,
+    const EActorTagFilterMode FilterMode,
+    FHitResult& OutHit
+)
+{
+    BuildUnitPrismConvex(NumSides);
+
+    const FCylinderTraceQueryContext Context = MakeQueryContext({ Tag }, { Radius });
+    if (!Context.World)
+    {
+        return false;
+    }
+
+    // スケールは寸法で決めるので、姿勢は位置と回転だけ使う
+    const FTransform StartPose(StartTransform.GetRotation(), StartTransform.GetLocation());
+    const FTransform EndPose(EndTransform.GetRotation(), EndTransform.GetLocation());
+
+    FCollisionQueryParams QueryParams = Context.QueryParams;
+
+    const FCylinderTraceTagSnapshot* TagSnapshot = Tag.IsNone() ? nullptr : Context.TagSnapshots.Find(Tag);
+    if (TagSnapshot && FilterMode == EActorTagFilterMode::Exclude)
+    {
+        for (const AActor* Actor : TagSnapshot->Actors)
+        {
+            QueryParams.AddIgnoredActor(Actor);
+        }
+    }
+
+    // 中心は線形に動くので、両端の外接球の箱で経路全体を覆える
+    const float Extent = FMath::Sqrt(Radius * Radius + HalfLength * HalfLength);
+    const FBox PathBox = FBox(StartPose.GetLocation(), StartPose.GetLocation()).ExpandBy(Extent)
+        + FBox(EndPose.GetLocation(), EndPose.GetLocation()).ExpandBy(Extent);
+
+    FCollisionResponseParams TouchAllParams = Context.ResponseParams;
+    TouchAllParams.CollisionResponse.ReplaceChannels(ECR_Block, ECR_Overlap);
+
+    TArray<FOverlapResult> Overlaps;
+    Context.World->OverlapMultiByChannel(
+        Overlaps,
+        PathBox.GetCenter(),
+        FQuat::Identity,
+        Context.Channel,
+        FCollisionShape::MakeBox(PathBox.GetExtent()),
+        QueryParams,
+        TouchAllParams
+    );
+
+    // 判定形状（ShapeMode / MaxDeviationCm に合わせる。円柱でも凸でない相手には多角柱を使う）
+    const FVector Scale(Radius, Radius, 2.0f * HalfLength);
+    TOptional<FScaledPrismGeometry> ScaledConvex;
+    TOptional<Chaos::FCylinder> Cylinder;
+    if (Context.ShapeMode == ECylinderTraceShapeMode::ExactCylinder)
+    {
+        Cylinder.Emplace(Chaos::FVec3(0.0, 0.0, -HalfLength), Chaos::FVec3(0.0, 0.0, HalfLength), Radius);
+        MakeScaledPrism(Context, Scale, ScaledConvex);
+    }
+    else if (!MakeScaledPrism(Context, Scale, ScaledConvex))
+    {
+        return false;
+    }
+
+    TArray<FHitResult> Hits;
+    for (const FOverlapResult& Overlap : Overlaps)
+    {
+        UPrimitiveComponent* Component = Overlap.GetComponent();
+        if (!Component)
+        {
+            continue;
+        }
+
+        AActor* CandidateActor = Component->GetOwner();
+
+        // Include 対象外はヒットしても採用されないので、ナローフェーズ前に落とす
+        if (TagSnapshot && FilterMode == EActorTagFilterMode::Include && !TagSnapshot->Actors.Contains(CandidateActor))
+        {
+            continue;
+        }
+
+        const FBodyInstance* BodyInstance = Component->GetBodyInstance(NAME_None, true, Overlap.ItemIndex);
+        if (!BodyInstance)
+        {
+            continue;
+        }
+
+        FHitResult Hit;
+        Hit.Component = Component;
+        Hit.HitObjectHandle = FActorInstanceHandle(CandidateActor);
+        Hit.Item = Overlap.ItemIndex;
+
+        const bool bBodyHit = Cylinder.IsSet()
+            ? AdvanceGeometryAgainstBody(*BodyInstance, Cylinder.GetValue(), Extent, StartPose, EndPose, Hit, ScaledConvex.GetPtrOrNull())
+            : AdvanceGeometryAgainstBody(*BodyInstance, ScaledConvex.GetValue(), Extent, StartPose, EndPose, Hit);
+
+        if (bBodyHit)
+        {
+            Hits.Add(Hit);
+        }
+    }
+
+    Hits.StableSort([](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; });
+
+    for (const FHitResult& Hit : Hits)
+    {
+        if (!IsBlockingResponse(Context, Hit) || !ShouldAcceptActorByTag(Hit.GetActor(), Tag, FilterMode))
+        {
+            continue;
+        }
+
+        OutHit = Hit;
+        OutHit.bBlockingHit = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool UCylinderConvexTraceComponent::CylinderTraceAlongCurve(
+    const UCvCurveComponent* Curve,
+    const float Radius,
+    const float HalfLength,
+    const float MaxFlattenError,
+    const FName Tag,
+    const EActorTagFilterMode FilterMode,
+    FHitResult& OutHit,
+    float& OutDistanceAlongCurve
+)
+{
+    OutDistanceAlongCurve = 0.0f;
+
+    const FCvCurveViewPtr View = Curve ? Curve->GetCurveView() : nullptr;
+    if (!View.IsValid() || !View->IsValid())
+    {
+        return false;
+    }
+
+    BuildUnitPrismConvex(NumSides);
+
+    // 曲線を折れ線に（ワールド空間、距離は曲線の基準のまま）
+    TArray<FVector> Points;
+    TArray<float> Distances;
+    View->Flatten(MaxFlattenError, Curve->GetComponentTransform(), Points, Distances);
+    if (Points.Num() < 2)
+    {
+        return false;
+    }
+
+    const FCylinderTraceQueryContext Context = MakeQueryContext({ Tag }, { Radius });
+    if (!Context.World)
+    {
+        return false;
+    }
+
+    FCollisionQueryParams QueryParams = Context.QueryParams;
+
+    const FCylinderTraceTagSnapshot* TagSnapshot = Tag.IsNone() ? nullptr : Context.TagSnapshots.Find(Tag);
+    if (TagSnapshot && FilterMode == EActorTagFilterMode::Exclude)
+    {
+        for (const AActor* Actor : TagSnapshot->Actors)
+        {
+            QueryParams.AddIgnoredActor(Actor);
+        }
+    }
+
+    // 区間ごとの掃引箱と、それらをまとめた箱
+    const float Extent = FMath::Sqrt(Radius * Radius + HalfLength * HalfLength);
+    const int32 NumSegments = Points.Num() - 1;
+
+    TArray<FBox> SegmentBoxes;
+    SegmentBoxes.Reserve(NumSegments);
+    FBox PathBox(ForceInit);
+    for (int32 i = 0; i < NumSegments; ++i)
+    {
+        const FBox& Box = SegmentBoxes.Add_GetRef(FBox(Points[i], Points[i]).ExpandBy(Extent) + FBox(Points[i + 1], Points[i + 1]).ExpandBy(Extent));
+        PathBox += Box;
+    }
+
+    // まとめた箱で1回だけ候補を集める（応答が Ignore 以外の全て）
+    FCollisionResponseParams TouchAllParams = Context.ResponseParams;
+    TouchAllParams.CollisionResponse.ReplaceChannels(ECR_Block, ECR_Overlap);
+
+    TArray<FOverlapResult> Overlaps;
+    Context.World->OverlapMultiByChannel(
+        Overlaps,
+        PathBox.GetCenter(),
+        FQuat::Identity,
+        Context.Channel,
+        FCollisionShape::MakeBox(PathBox.GetExtent()),
+        QueryParams,
+        TouchAllParams
+    );
+
+    // 候補の境界（区間の間引き用）と、折れ目での回転の判定に使うボディ
+    struct FCurveCandidate
+    {
+        UPrimitiveComponent* Component = nullptr;
+        int32 ItemIndex = INDEX_NONE;
+        FBox Bounds;
+    };
+
+    TArray<FCurveCandidate> Candidates;
+    Candidates.Reserve(Overlaps.Num());
+    for (const FOverlapResult& Overlap : Overlaps)
+    {
+        UPrimitiveComponent* Component = Overlap.GetComponent();
+        if (!Component)
+        {
+            continue;
+        }
+
+        if (TagSnapshot && FilterMode == EActorTagFilterMode::Include && !TagSnapshot->Actors.Contains(Component->GetOwner()))
+        {
+            // Include では対象外のヒットは無視して進むだけなので、区間の間引きには対象の境界だけを使う
+            continue;
+        }
+        Candidates.Add({ Component, Overlap.ItemIndex, Component->Bounds.GetBox() });
+    }
+
+    if (Candidates.Num() == 0)
+    {
+        return false;
+    }
+
+    const FVector Scale(Radius, Radius, 2.0f * HalfLength);
+
+    // 折れ目での回転の判定形状（ShapeMode / MaxDeviationCm に合わせる。円柱でも凸でない相手には多角柱を使う）
+    TOptional<FScaledPrismGeometry> ScaledConvex;
+    TOptional<Chaos::FCylinder> Cylinder;
+    if (Context.ShapeMode == ECylinderTraceShapeMode::ExactCylinder)
+    {
+        Cylinder.Emplace(Chaos::FVec3(0.0, 0.0, -HalfLength), Chaos::FVec3(0.0, 0.0, HalfLength), Radius);
+    }
+    MakeScaledPrism(Context, Scale, ScaledConvex);
+
+    // タグ不一致でブロックした Actor（QueryParams の無視リストと同じ内容。折れ目の判定で使う）
+    TSet<const AActor*> RejectedActors;
+
+    // 折れ目の位置で、前の区間の向きから次の区間の向きへ回した時に新たに掃く範囲を判定する
+    // （区間のスイープは向きが固定なので、曲がりの外側にできる隙間をここで埋める）
+    const auto TraceCorner = [&](const FVector& Joint, const FQuat& FromRot, const FQuat& ToRot, FHitResult& OutCornerHit) -> bool
+    {
+        if (!Cylinder.IsSet() && !ScaledConvex.IsSet())
+        {
+            return false;
+        }
+
+        const FTransform FromPose(FromRot, Joint);
+        const FTransform ToPose(ToRot, Joint);
+        const FBox JointBox = FBox(Joint, Joint).ExpandBy(Extent);
+
+        TArray<FHitResult> Hits;
+        for (const FCurveCandidate& Candidate : Candidates)
+        {
+            AActor* CandidateActor = Candidate.Component->GetOwner();
+            if (!Candidate.Bounds.Intersect(JointBox) || RejectedActors.Contains(CandidateActor))
+            {
+                continue;
+            }
+
+            const FBodyInstance* BodyInstance = Candidate.Component->GetBodyInstance(NAME_None, true, Candidate.ItemIndex);
+            if (!BodyInstance)
+            {
+                continue;
+            }
+
+            FHitResult Hit;
+            Hit.Component = Candidate.Component;
+            Hit.HitObjectHandle = FActorInstanceHandle(CandidateActor);
+            Hit.Item = Candidate.ItemIndex;
+
+            const bool bBodyHit = Cylinder.IsSet()
+                ? AdvanceGeometryAgainstBody(*BodyInstance, Cylinder.GetValue(), Extent, FromPose, ToPose, Hit, ScaledConvex.GetPtrOrNull())
+                : AdvanceGeometryAgainstBody(*BodyInstance, ScaledConvex.GetValue(), Extent, FromPose, ToPose, Hit);
+
+            if (bBodyHit)
+            {
+                Hits.Add(Hit);
+            }
+        }
+
+        Hits.StableSort([](const FHitResult& A, const FHitResult& B) { return A.Time < B.Time; });
+
+        for (const FHitResult& Hit : Hits)
+        {
+            if (!IsBlockingResponse(Context, Hit))
+            {
+                continue;
+            }
+
+            AActor* HitActor = Hit.GetActor();
+            if (ShouldAcceptActorByTag(HitActor, Tag, FilterMode))
+            {
+                OutCornerHit = Hit;
+                return true;
+            }
+
+            if (HitActor)
+            {
+                QueryParams.AddIgnoredActor(HitActor);
+                RejectedActors.Add(HitActor);
+            }
+        }
+        return false;
+    };
+
+    TOptional<FQuat> PrevRot;
+    for (int32 i = 0; i < NumSegments; ++i)
+    {
+        const FVector& Start = Points[i];
+        const FVector& End = Points[i + 1];
+        const FVector Delta = End - Start;
+        if (Delta.IsNearlyZero())
+        {
+            continue;
+        }
+
+        // 他のトレースと同じく、ローカルZ-方向が進行方向
+        const FQuat Rot = FRotationMatrix::MakeFromZ(-Delta).ToQuat();
+
+        const bool bTurns = PrevRot.IsSet() && PrevRot->AngularDistance(Rot) > KINDA_SMALL_NUMBER;
+        const FQuat FromRot = PrevRot.Get(Rot);
+        PrevRot = Rot;
+
+        if (bTurns)
+        {
+            FHitResult CornerHit;
+            if (TraceCorner(Start, FromRot, Rot, CornerHit))
+            {
+                OutHit = CornerHit;
+                OutHit.bBlockingHit = true;
+                OutDistanceAlongCurve = Distances[i];
+                return true;
+            }
+        }
+
+        const FBox& SegmentBox = SegmentBoxes[i];
+        if (!Candidates.ContainsByPredicate([&SegmentBox](const FCurveCandidate& Candidate) { return Candidate.Bounds.Intersect(SegmentBox); }))
+        {
+            continue;
+        }
+
+        TArray<FHitResult> Hits;
+        CollectPathHits(Context, Start, End, Rot, Scale, QueryParams, Hits);
+
+        for (const FHitResult& Hit : Hits)
+        {
+            if (!IsBlockingResponse(Context, Hit))
+            {
+                continue;
+            }
+
+            AActor* HitActor = Hit.GetActor();
+            if (ShouldAcceptActorByTag(HitActor, Tag, FilterMode))
+            {
+                OutHit = Hit;
+                OutHit.bBlockingHit = true;
+                OutDistanceAlongCurve = FMath::Lerp(Distances[i], Distances[i + 1], Hit.Time);
+                return true;
+            }
+
+            // 不一致のブロック相手は以降の区間でも無視（フィルタ状態を持ち越す）
+            if (HitActor)
+            {
+                QueryParams.AddIgnoredActor(HitActor);
+                RejectedActors.Add(HitActor);
+            }
+        }
+    }
+
+    return false;
+}
+
+FCylinderTraceCoherenceHandle UCylinderConvexTraceComponent::CreateCoherentTraceHandle(const float InflationMargin)
+{
+    FCylinderTraceCoherenceHandle Handle;
+    Handle.Id = NextCoherentTraceId++;
+
+    FCoherentTraceCache& Cache = CoherentTraceCaches.Add(Handle.Id);
+    Cache.InflationMargin = FMath::Max(InflationMargin, 0.0f);
+    return Handle;
+}
+
+void UCylinderConvexTraceComponent::ReleaseCoherentTraceHandle(const FCylinderTraceCoherenceHandle Handle)
+{
+    CoherentTraceCaches.Remove(Handle.Id);
+}
+
+void UCylinderConvexTraceComponent::GatherCoherentTraceCandidates(
+    const FCylinderTraceQueryContext& Context,
+    const FBox& SweptBox,
+    const float Radius,
+    const float HalfLength,
+    FCoherentTraceCache& Cache
+) const
+{
+    Cache.bValid = true;
+    Cache.InflatedBox = SweptBox.ExpandBy(Cache.InflationMargin);
+    Cache.Radius = Radius;
+    Cache.HalfLength = HalfLength;
+    Cache.Candidates.Reset();
+
+    if (!Context.World)
+    {
+        return;
+    }
+
+    // 応答が Ignore 以外の相手を全て候補にする（Block かどうかは再スイープ時に判定）
+    FCollisionResponseParams TouchAllParams = Context.ResponseParams;
+    TouchAllParams.CollisionResponse.ReplaceChannels(ECR_Block, ECR_Overlap);
+
+    TArray<FOverlapResult> Overlaps;
+    Context.World->OverlapMultiByChannel(
+        Overlaps,
+        Cache.InflatedBox.GetCenter(),
+        FQuat::Identity,
+        Context.Channel,
+        FCollisionShape::MakeBox(Cache.InflatedBox.GetExtent()),
+        Context.QueryParams,
+        TouchAllParams
+    );
+
+    Cache.Candidates.Reserve(Overlaps.Num());
+    for (const FOverlapResult& Overlap : Overlaps)
+    {
+        if (UPrimitiveComponent* Component = Overlap.GetComponent())
+        {
+            FCoherentTraceCandidate& Candidate = Cache.Candidates.AddDefaulted_GetRef();
+            Candidate.Component = Component;
+            Candidate.ItemIndex = Overlap.ItemIndex;
+        }
+    }
+}
+
+bool UCylinderConvexTraceComponent::CylinderTraceCoherent(
+    const FCylinderTraceCoherenceHandle Handle,
+    const FTransform& Transform,
+    const float TraceDistance,
+    const float Radius,
+    const float HalfLength,
+    const FName Tag,
+    const EActorTagFilterMode FilterMode,
+    FHitResult& OutHit
+)
+{
+
+    FCoherentTraceCache* Cache = CoherentTraceCaches.Find(Handle.Id);
+    if (!Cache)
+    {
+        // 不明なハンドルはキャッシュなしで処理
+        return CylinderTraceStateless(Transform, TraceDistance, Radius, HalfLength, Tag, FilterMode, OutHit);
+    }
+
+    FCylinderTraceRequest Request;
+    Request.Transform = Transform;
+    Request.TraceDistance = TraceDistance;
+    Request.Radius = Radius;
+    Request.HalfLength = HalfLength;
+    Request.Tag = Tag;
+    Request.FilterMode = FilterMode;
+
+    const FCylinderTraceQueryContext Context = MakeQueryContext({ Tag }, { Radius });
+
+    const FVector Scale(Radius, Radius, 2.0f * HalfLength);
+    const FVector Start = Transform.GetLocation();
+    const FVector End = Start - Transform.GetUnitAxis(EAxis::Z) * TraceDistance; // ローカルZ-方向
+    const FQuat Rot = Transform.GetRotation();
+
+    FCollisionQueryParams QueryParams = Context.QueryParams;
+    if (!ApplyTagPrefilter(Context, Request, Start, End, QueryParams))
+    {
+        return false;
+    }
+
+    // 経路（円柱の外接球を掃いた箱）がキャッシュ範囲に収まる間は候補を使い回す
+    const float Extent = FMath::Sqrt(Radius * Radius + HalfLength * HalfLength);
+    const FBox SweptBox = FBox(Start, Start).ExpandBy(Extent) + FBox(End, End).ExpandBy(Extent);
+
+    if (!Cache->bValid
+        || !Cache->InflatedBox.IsInside(SweptBox)
+        || !FMath::IsNearlyEqual(Cache->Radius, Radius)
+        || !FMath::IsNearlyEqual(Cache->HalfLength, HalfLength))
+    {
+        GatherCoherentTraceCandidates(Context, SweptBox, Radius, HalfLength, *Cache);
+    }
+
+    // 候補ごとのナローフェーズ（形状は ShapeMode に合わせる。円柱でも凸でない相手には多角柱を使う）
+    TOptional<FScaledPrismGeometry> ScaledConvex;
+    TOptional<Chaos::FCylinder> Cylinder;
+    if (Context.ShapeMode == ECylinderTraceShapeMode::ExactCylinder)
+    {
+        Cylinder.Emplace(Chaos::FVec3(0.0, 0.0, -HalfLength), Chaos::FVec3(0.0, 0.0, HalfLength), Radius);
+        MakeScaledPrism(Context, Scale, ScaledConvex);
+    }
+    else if (!MakeScaledPrism(Context, Scale, ScaledConvex))
+    {
+        return false;
+    }
+
+    bool bHit = false;
+    for (const FCoherentTraceCandidate& Candidate : Cache->Candidates)
+    {
+        UPrimitiveComponent* Component = Candidate.Component.Get();
+        if (!Component || !Component->IsQueryCollisionEnabled())
+        {
+            continue;
+        }
+
+        AActor* CandidateActor = Component->GetOwner();
+        if (CandidateActor && QueryParams.GetIgnoredActors().Contains(CandidateActor->GetUniqueID()))
+        {
+            continue;
+        }
+
+        const FBodyInstance* BodyInstance = Component->GetBodyInstance(NAME_None, true, Candidate.ItemIndex);
+        if (!BodyInstance)
+        {
+            continue;
+        }
+
+        FHitResult Hit;
+        Hit.Component = Component;
+        Hit.HitObjectHandle = FActorInstanceHandle(CandidateActor);
+        Hit.Item = Candidate.ItemIndex;
+
+        const bool bBodyHit = Cylinder.IsSet()
+            ? SweepGeometryAgainstBody(*BodyInstance, Cylinder.GetValue(), Start, End, Rot, Hit, ScaledConvex.GetPtrOrNull())
+            : SweepGeometryAgainstBody(*BodyInstance, ScaledConvex.GetValue(), Start, End, Rot, Hit);
+
+        if (!bBodyHit || (bHit && Hit.Time >= OutHit.Time))
+        {
+            continue;
+        }
+
+        if (!IsBlockingResponse(Context, Hit) || !ShouldAcceptActorByTag(CandidateActor, Tag, FilterMode))
+        {
+            continue;
+        }
+
+        Hit.bBlockingHit = true;
+        OutHit = Hit;
+        bHit = true;
+    }
+
+    return bHit;
+}
+
+FCylinderTraceBatchHandle UCylinderConvexTraceComponent::EnqueueCylinderTraceBatch(const TArray<FCylinderTraceRequest>& Requests)
+{
+    check(IsInGameThread());
+
+    // 形状はゲームスレッドで用意してからスナップショットに載せる
+    BuildUnitPrismConvex(NumSides);
+
+    TArray<FName> Tags;
+    TArray<float> Radii;
+    for (const FCylinderTraceRequest& Request : Requests)
+    {
+        Tags.AddUnique(Request.Tag);
+        Radii.Add(Request.Radius);
+    }
+
+    FPendingTraceBatch Batch;
+    Batch.Id = NextTraceBatchId++;
+    Batch.Work = MakeUnique<FTraceBatchWork>();
+
+    FTraceBatchWork& Work = *Batch.Work;
+    Work.Context = MakeQueryContext(Tags, Radii);
+    Work.Requests = Requests;
+    Work.QueryParams.Reserve(Requests.Num());
+    Work.Skipped.Init(false, Requests.Num());
+    Work.PathHits.SetNum(Requests.Num());
+
+    // タグの事前絞り込み（無視リストに Actor を積む）はここで済ませ、ワーカーには UObject を触らせない
+    for (int32 Index = 0; Index < Requests.Num(); ++Index)
+    {
+        const FCylinderTraceRequest& Request = Requests[Index];
+        const FVector Start = Request.Transform.GetLocation();
+        const FVector End = Start - Request.Transform.GetUnitAxis(EAxis::Z) * Request.TraceDistance; // ローカルZ-方向
+
+        FCollisionQueryParams& QueryParams = Work.QueryParams.Add_GetRef(Work.Context.QueryParams);
+        Work.Skipped[Index] = !ApplyTagPrefilter(Work.Context, Request, Start, End, QueryParams);
+    }
+
+    // Work はタスクの完了を待ってからゲームスレッドで解放するので、生ポインタで渡す
+    Batch.Task = UE::Tasks::Launch(
+        UE_SOURCE_LOCATION,
+        [WorkPtr = Batch.Work.Get()]()
+        {
+            FTraceBatchWork& Work = *WorkPtr;
+            ParallelFor(Work.Requests.Num(), [&Work](const int32 Index)
+            {
+                if (Work.Skipped[Index])
+                {
+                    return;
+                }
+
+                const FCylinderTraceRequest& Request = Work.Requests[Index];
+                const FVector Scale(Request.Radius, Request.Radius, 2.0f * Request.HalfLength);
+                const FVector Start = Request.Transform.GetLocation();
+                const FVector End = Start - Request.Transform.GetUnitAxis(EAxis::Z) * Request.TraceDistance;
+                const FQuat Rot = Request.Transform.GetRotation();
+
+                if (Work.Context.ShapeMode == ECylinderTraceShapeMode::ExactCylinder)
+                {
+                    GatherExactCylinderCandidates(Work.Context, Start, End, Rot, Request.Radius, Request.HalfLength, Work.QueryParams[Index], Work.PathHits[Index]);
+                }
+                else
+                {
+                    CollectPathHits(Work.Context, Start, End, Rot, Scale, Work.QueryParams[Index], Work.PathHits[Index]);
+                }
+            });
+        }
+    );
+
+    PendingTraceBatches.Add(MoveTemp(Batch));
+    SetComponentTickEnabled(true);
+
+    // 登録したフレームのうちに終わらせる（GC がタスクと重ならないよう GC 前にも待つ）
+    if (!PostActorTickHandle.IsValid())
+    {
+        PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UCylinderConvexTraceComponent::HandleWorldPostActorTick);
+    }
+    if (!PreGarbageCollectHandle.IsValid())
+    {
+        PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UCylinderConvexTraceComponent::HandlePreGarbageCollect);
+    }
+
+    FCylinderTraceBatchHandle Handle;
+    Handle.Id = PendingTraceBatches.Last().Id;
+    return Handle;
+}
+
+void UCylinderConvexTraceComponent::ResolveTraceBatch(const FTraceBatchWork& Work, TArray<FCylinderTraceResult>& OutResults)
+{
+    OutResults.SetNum(Work.Requests.Num());
+
+    TArray<FHitResult> Hits;
+    for (int32 Index = 0; Index < Work.Requests.Num(); ++Index)
+    {
+        FCylinderTraceResult& Result = OutResults[Index];
+        if (Work.Skipped[Index])
+        {
+            continue;
+        }
+
+        const FCylinderTraceRequest& Request = Work.Requests[Index];
+        const TArray<FHitResult>* PathHits = &Work.PathHits[Index];
+        if (Work.Context.ShapeMode == ECylinderTraceShapeMode::ExactCylinder)
+        {
+            const FVector Start = Request.Transform.GetLocation();
+            const FVector End = Start - Request.Transform.GetUnitAxis(EAxis::Z) * Request.TraceDistance;
+            RefineExactCylinderCandidates(Work.Context, *PathHits, Start, End, Request.Transform.GetRotation(), Request.Radius, Request.HalfLength, Hits);
+            PathHits = &Hits;
+        }
+
+        Result.bHit = SelectFirstAcceptedHit(Work.Context, *PathHits, Request.Tag, Request.FilterMode, Result.Hit);
+    }
+}
+
+bool UCylinderConvexTraceComponent::TryGetCylinderTraceBatchResults(const FCylinderTraceBatchHandle Handle, TArray<FCylinderTraceResult>& OutResults)
+{
+    return CompletedTraceBatches.RemoveAndCopyValue(Handle.Id, OutResults);
+}
+
+void UCylinderConvexTraceComponent::TickComponent(const float DeltaTime, const ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+    // 前フレームに渡した結果は破棄（取りに来なかったものは捨てる）
+    CompletedTraceBatches.Reset();
+
+    for (int32 i = 0; i < PendingTraceBatches.Num();)
+    {
+        FPendingTraceBatch& Batch = PendingTraceBatches[i];
+        if (!Batch.Task.IsCompleted())
+        {
+            ++i;
+            continue;
+        }
+
+        FCylinderTraceBatchHandle Handle;
+        Handle.Id = Batch.Id;
+
+        TArray<FCylinderTraceResult>& Results = CompletedTraceBatches.Add(Batch.Id);
+        ResolveTraceBatch(*Batch.Work, Results);
+        PendingTraceBatches.RemoveAtSwap(i);
+
+        OnCylinderTraceBatchCompleted.Broadcast(Handle, Results);
+    }
+
+    if (PendingTraceBatches.Num() == 0 && CompletedTraceBatches.Num() == 0)
+    {
+        SetComponentTickEnabled(false);
+    }
+}
+
+void UCylinderConvexTraceComponent::FinishPendingTraceBatchTasks()
+{
+    for (FPendingTraceBatch& Batch : PendingTraceBatches)
+    {
+        Batch.Task.Wait();
+    }
+}
+
+void UCylinderConvexTraceComponent::HandleWorldPostActorTick(UWorld* InWorld, const ELevelTick TickType, const float DeltaSeconds)
+{
+    if (InWorld == GetWorld())
+    {
+        FinishPendingTraceBatchTasks();
+    }
+}
+
+void UCylinderConvexTraceComponent::HandlePreGarbageCollect()
+{
+    FinishPendingTraceBatchTasks();
+}
+
+void UCylinderConvexTraceComponent::WaitForPendingTraceBatches()
+{
+    // World/形状を参照しているタスクが残らないよう待つ
+    FinishPendingTraceBatchTasks();
+    PendingTraceBatches.Reset();
+    CompletedTraceBatches.Reset();
+
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+    PostActorTickHandle.Reset();
+    FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+    PreGarbageCollectHandle.Reset();
+}
+
+void UCylinderConvexTraceComponent::OnUnregister()
+{
+    WaitForPendingTraceBatches();
+
+    // 候補は登録先ワールドのものなので、次の登録時は集め直す
+    for (TPair<int32, FCoherentTraceCache>& Pair : CoherentTraceCaches)
+    {
+        Pair.Value.bValid = false;
+        Pair.Value.Candidates.Reset();
+    }
+
+    Super::OnUnregister();
 }
\ No newline at end of file
@@ -3,8 +3,15 @@
 #include "CoreMinimal.h"
 #include "Components/PrimitiveComponent.h"
 #include "PhysicsEngine/BodySetup.h"
+#include "CylinderPrismShapeCache.h"
+#include "Tasks/Task.h"
+#include "Chaos/Cylinder.h"
+#include "Chaos/Convex.h"
+#include "Chaos/ImplicitObjectScaled.h"
 #include "CylinderConvexTraceComponent.generated.h"
 
+class UCvCurveComponent;
+
 UENUM(BlueprintType)
 enum class EActorTagFilterMode : uint8
 {
@@ -12,10 +19,161 @@ enum class EActorTagFilterMode : uint8
     Exclude UMETA(DisplayName="Exclude"),
 };
 
+UENUM(BlueprintType)
+enum class ECylinderTraceShapeMode : uint8
+{
+    /** NumSides 角柱の凸形状でスイープ（従来動作） */
+    Prism UMETA(DisplayName="Prism"),
+    /** 解析的な円柱でスイープ（カプセルで候補を集め、候補ごとに円柱で判定。Prism より高価） */
+    ExactCylinder UMETA(DisplayName="Exact Cylinder"),
+};
+
+/** 円柱トレース1件分の要求（CylinderTraceFromTransform の引数と同じ意味） */
+USTRUCT(BlueprintType)
+struct FCylinderTraceRequest
+{
+    GENERATED_BODY()
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderTrace")
+    FTransform Transform;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderTrace")
+    float TraceDistance = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderTrace")
+    float Radius = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderTrace")
+    float HalfLength = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderTrace")
+    FName Tag;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderTrace")
+    EActorTagFilterMode FilterMode = EActorTagFilterMode::Include;
+};
+
+/** 円柱トレース1件分の結果 */
+USTRUCT(BlueprintType)
+struct FCylinderTraceResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    bool bHit = false;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    FHitResult Hit;
+};
+
+/** 非同期バッチの識別子（0 は無効） */
+USTRUCT(BlueprintType)
+struct FCylinderTraceBatchHandle
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    int32 Id = 0;
+
+    bool IsValid() const { return Id != 0; }
+};
+
+/** 円柱オーバーラップの結果1件 */
+USTRUCT(BlueprintType)
+struct FCylinderOverlapResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    TObjectPtr<UPrimitiveComponent> Component = nullptr;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    TObjectPtr<AActor> Actor = nullptr;
+
+    /** インスタンス/ボディの番号（FOverlapResult::ItemIndex） */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    int32 ItemIndex = INDEX_NONE;
+
+    /** このコンポーネントと相手の応答が Block か */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    bool bBlocking = false;
+
+    /** bComputePenetration 指定時のみ有効 */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    bool bHasPenetration = false;
+
+    /** 押し出しに必要な距離（cm） */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    float PenetrationDepth = 0.0f;
+
+    /** 円柱を押し出す向き（相手から離れる向き） */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    FVector PenetrationDirection = FVector::ZeroVector;
+};
+
+/** フレーム間キャッシュ付きトレースの識別子（0 は無効） */
+USTRUCT(BlueprintType)
+struct FCylinderTraceCoherenceHandle
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category="CylinderTrace")
+    int32 Id = 0;
+
+    bool IsValid() const { return Id != 0; }
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnCylinderTraceBatchCompleted, FCylinderTraceBatchHandle, Handle, const TArray<FCylinderTraceResult>&, Results);
+
+/**
+ * タグ索引（UActorTagIndexSubsystem）から取った1タグ分の対象Actor。
+ * Exclude ではスイープ前の無視リストに、Include では経路に掛かる対象が無い場合の早期棄却に使います。
+ * 事前の絞り込み専用で、ヒットを採用するかの最終判定は常に AActor::ActorHasTag で行います。
+ */
+struct FCylinderTraceTagSnapshot
+{
+    TSet<const AActor*> Actors;
+
+    /** 対象Actorの衝突コンポーネント境界 */
+    TArray<FBox> Bounds;
+};
+
+/**
+ * スレッドをまたいで使うクエリ条件のスナップショット（ゲームスレッドで作成）。
+ * 形状は共有参照で保持するので、実行中に NumSides が変わっても影響を受けません。
+ */
+struct FCylinderTraceQueryContext
+{
+    const UWorld* World = nullptr;
+
+    TSharedPtr<FCylinderPrismShape> Shape;
+
+    ECollisionChannel Channel = ECC_WorldDynamic;
+
+    FCollisionQueryParams QueryParams;
+
+    FCollisionResponseParams ResponseParams;
+
+    int32 MaxFilterIterations = 32;
+
+    bool bSinglePassTagFilter = false;
+
+    ECylinderTraceShapeMode ShapeMode = ECylinderTraceShapeMode::Prism;
+
+    /** 0 より大きければ、Shape ではなく半径ごとに DeviationShapes から選ぶ */
+    float MaxDeviation = 0.0f;
+
+    /** 角数 → 形状。作成時に指定した半径で選ばれる角数だけ（無い角数は Shape で代用） */
+    TMap<int32, TSharedPtr<FCylinderPrismShape>> DeviationShapes;
+
+    /** 使用するタグごとの索引スナップショット（索引が無い・対象が多すぎるタグは無く、絞り込みなしで処理） */
+    TMap<FName, FCylinderTraceTagSnapshot> TagSnapshots;
+};
+
 /**
  * 描画しない、凸(Convex)衝突のみを持つ「有限円柱（多角柱近似）」スイープ用コンポーネント。
  *
- * - 形状：半径1・高さ1 の N角柱（Z軸が高さ方向）を UBodySetup の FKConvexElem として生成（1回だけ）
+ * - 形状：半径1・高さ1 の N角柱（Z軸が高さ方向）。クック済み形状は角数ごとに全コンポーネントで共有（FCylinderPrismShapeCache）
  * - スイープ：MoveComponent(bSweep=true) を使用（内部で Chaos の Convex sweep）
  * - 円柱寸法：ScaleXY=Radius, ScaleZ=2*HalfLength で指定
  * - 方向：Transform の回転をそのまま使用（ローカルZが円柱軸）
@@ -40,17 +198,57 @@ public:
     UPROPERTY(EditAnywhere, Category="CylinderTrace", meta=(ClampMin="1", ClampMax="256"))
     int32 MaxFilterIterations = 32;
 
+    /**
+     * true: タグ不一致のヒットを再スイープで回避せず、1回のマルチヒットスイープ結果から
+     * 最初に条件を満たすヒットを選びます（除外Actor数が増えてもコスト一定。コンポーネントも動かさない）。
+     * false: 従来通り IgnoreActorWhenMoving + 再スイープ（最大 MaxFilterIterations 回）。
+     */
+    UPROPERTY(EditAnywhere, Category="CylinderTrace")
+    bool bSinglePassTagFilter = false;
+
+    /**
+     * Prism: NumSides 角柱で近似（頂点数に比例したサポート関数コスト）。スイープはシーンクエリ1回。
+     * ExactCylinder: 角柱の近似誤差が無い真円柱で判定（精度のためのモード。速くはならない）。
+     * 外接カプセルのシーンクエリで候補を集めた上で、候補のボディごとに円柱をスイープし直すため、
+     * 同じ条件の Prism より常に高価です（候補が多いほど差が開く）。常に1パスのタグフィルタで処理します。
+     * 三角形メッシュ・ハイトフィールドの相手は円柱で判定できないため、その相手だけ Prism と同じ多角柱で判定します。
+     */
+    UPROPERTY(EditAnywhere, Category="CylinderTrace")
+    ECylinderTraceShapeMode ShapeMode = ECylinderTraceShapeMode::Prism;
+
+    /**
+     * 0 より大きい場合、NumSides の代わりにトレースごとの Radius から角数を選びます（Prism のみ）。
+     * 多角柱と真円のずれ（cm）がこの値以下になる最小のプリセット角数を使うので、
+     * 小さい半径では安い形状、大きい半径では精度の高い形状になります。
+     * プリセット角数の形状は有効にした時（OnRegister / SetMaxDeviationCm）にゲームスレッドで全て用意し、
+     * 全コンポーネントで共有します（トレース中には用意しないので、ワーカーからのトレースでも使える）。
+     */
+    UPROPERTY(EditAnywhere, Category="CylinderTrace", meta=(ClampMin="0.0"))
+    float MaxDeviationCm = 0.0f;
+
+    /**
+     * タグ索引のスナップショット（事前の絞り込み）を使う対象Actor数の上限。
+     * スナップショットの作成と Exclude の無視リストはトレースごとに対象数に比例して掛かるため、
+     * これを超えるタグはヒットごとの ActorHasTag だけで判定します。
+     */
+    UPROPERTY(EditAnywhere, Category="CylinderTrace", meta=(ClampMin="0"))
+    int32 MaxTagSnapshotActors = 64;
+
     /** 微小押し出し（cm）。同一ヒット繰り返し回避用（基本はIgnoreで回避できるが保険） */
     UPROPERTY(EditAnywhere, Category="CylinderTrace", meta=(ClampMin="0.0", ClampMax="10.0"))
     float AdvanceEpsilonCm = 0.1f;
 
 public:
-    /** 衝突形状（単位N角柱）を構築（必要なら自動でクック）。通常は明示呼び不要。 */
+    /** 衝突形状（単位N角柱）を共有キャッシュから取得（未クックの角数ならここでクック）。通常は明示呼び不要。 */
     void BuildUnitPrismConvex(int32 InNumSides);
 
     /** QueryOnly想定の衝突設定（必要に応じて呼び出し） */
     void ConfigureCollision(ECollisionChannel ObjectType, ECollisionResponse ResponseToAll);
 
+    /** MaxDeviationCm を変更し、使うプリセット角数の形状を用意する（ゲームスレッド。実行中のトレースが無い時に呼ぶこと） */
+    UFUNCTION(BlueprintCallable, Category="CylinderTrace")
+    void SetMaxDeviationCm(float InMaxDeviationCm);
+
     /**
      * 指定Transformの「ローカルZ-方向」に、有限円柱（多角柱近似）でスイープします。
      *
@@ -72,23 +270,272 @@ public:
         FHitResult& OutHit
     );
 
+    /**
+     * CylinderTraceFromTransform と同じ条件のスイープを、コンポーネントを一切動かさずに行います。
+     *
+     * - キャッシュ済みConvexを Transform/Scale を明示してシーンクエリAPIで直接スイープ
+     * - SetWorldLocation/Scale・MoveComponent を使わないため、Bounds/Overlap/物理Body の更新が発生しない
+     * - コンポーネントは読み取りのみ。シーンクエリを実行してよいスレッドなら並行して呼び出し可能
+     * - 形状は事前にゲームスレッドで構築済みであること（未構築なら false。MaxDeviationCm の形状も同様）
+     * - ゲームスレッド以外ではタグ索引のスナップショットを使わない（Actor の一覧を読まない）。
+     *   タグの判定はヒットした Actor の Tags を読むので、その間に Tags を書き換えないこと
+     */
+    bool CylinderTraceStateless(
+        const FTransform& Transform,
+        float TraceDistance,
+        float Radius,
+        float HalfLength,
+        FName Tag,
+        EActorTagFilterMode FilterMode,
+        FHitResult& OutHit
+    ) const;
+
+    /**
+     * 経路上で条件を満たす全ヒット（Block / Overlap）を時間順に返します。1回のスイープで完結し、
+     * コンポーネントは動かしません。
+     *
+     * - 各ヒットの bBlockingHit は、このコンポーネントと相手の応答が Block かどうか
+     * - ヒットはボディ（コンポーネント・Item・ボーン）ごとに最も手前の1件（複数シェイプのボディも1件）
+     * - 貫通する弾や範囲スキャン向け（ブロックで止まらない）
+     * - 形状の前提は CylinderTraceStateless と同じ（Prism は構築済みであること）
+     *
+     * @param MaxHits  返す最大件数（0以下なら無制限）。経路の手前から数えます
+     * @return 1件以上返したら true
+     */
+    UFUNCTION(BlueprintCallable, Category="CylinderTrace")
+    bool CylinderTraceMulti(
+        const FTransform& Transform,
+        float TraceDistance,
+        float Radius,
+        float HalfLength,
+        FName Tag,
+        EActorTagFilterMode FilterMode,
+        TArray<FHitResult>& OutHits,
+        int32 MaxHits = 0
+    ) const;
+
+    /**
+     * 今その場所で円柱と重なっているコンポーネントを全て返します（スイープしない、コンポーネントも動かさない）。
+     *
+     * - Prism はキャッシュ済みConvexでそのままオーバーラップ、ExactCylinder は外接カプセルで候補を集めて円柱で判定
+     *   （三角形メッシュ・ハイトフィールドの候補は同じ寸法の多角柱で判定）
+     * - 応答が Ignore 以外の相手が対象（bBlocking で Block かどうかを判別）
+     * - bComputePenetration 指定時は、相手ごとに押し出し量と向き（MTD）も求める（少し高価）
+     * - 形状の前提は CylinderTraceStateless と同じ
+     */
+    UFUNCTION(BlueprintCallable, Category="CylinderTrace")
+    bool CylinderOverlap(
+        const FTransform& Transform,
+        float Radius,
+        float HalfLength,
+        FName Tag,
+        EActorTagFilterMode FilterMode,
+        TArray<FCylinderOverlapResult>& OutOverlaps,
+        bool bComputePenetration = false
+    ) const;
+
+    /**
+     * 開始・終了の Transform の間を、回転も補間しながら円柱を動かして最初に条件を満たすヒットを返します。
+     *
+     * - 位置は線形、回転は Slerp で補間（回転するツールヘッド等を短いスイープの繰り返しで近似しなくてよい）
+     * - 経路全体の包囲箱で候補を集め、候補ごとに GJK 距離による保守的前進法で接触時刻を求める
+     *   （反復の上限で詰め切れなければ、残りの区間は回転を分割したスイープで判定）
+     * - 円柱の寸法・向きの意味は CylinderTraceFromTransform と同じ（ローカルZが軸）
+     * - Hit.Time は補間パラメータ（0〜1）、Hit.Location はその時刻の円柱中心
+     */
+    UFUNCTION(BlueprintCallable, Category="CylinderTrace")
+    bool CylinderTraceInterpolated(
+        const FTransform& StartTransform,
+        const FTransform& EndTransform,
+        float Radius,
+        float HalfLength,
+        FName Tag,
+        EActorTagFilterMode FilterMode,
+        FHitResult& OutHit
+    );
+
+    /**
+     * Curve に沿って円柱をスイープし、最初に条件を満たすヒットを返します（コンポーネントは動かさない）。
+     *
+     * - 曲線を MaxFlattenError（cm）以内の折れ線にして、各区間を順にスイープ（円柱の軸は進行方向）
+     * - 折れ目では前の区間の向きから次の区間の向きへその場で回し、曲がりの外側の隙間も判定（ヒットの距離は折れ目の位置）
+     * - 全区間の包囲箱で1回だけ候補を集め、候補に掛からない区間はスイープしない
+     * - タグ不一致でブロックした Actor は以降の区間でも無視（区間ごとに無視リストを作り直さない）
+     *
+     * @param OutDistanceAlongCurve  ヒット位置の曲線上の距離（Curve のコンポーネント空間、GetTransformAtDistance と同じ基準）
+     */
+    UFUNCTION(BlueprintCallable, Category="CylinderTrace")
+    bool CylinderTraceAlongCurve(
+        const UCvCurveComponent* Curve,
+        float Radius,
+        float HalfLength,
+        float MaxFlattenError,
+        FName Tag,
+        EActorTagFilterMode FilterMode,
+        FHitResult& OutHit,
+        float& OutDistanceAlongCurve
+    );
+
+    /**
+     * 複数の円柱トレースをワーカースレッドでまとめて実行します（ゲームスレッドは登録のみ）。
+     *
+     * - 各要求は bSinglePassTagFilter = true の CylinderTraceStateless と同じ条件で処理（登録時点の衝突設定・形状を使用）
+     * - ワーカーはシーンクエリだけを行い、タグ判定・応答判定・円柱の候補判定は結果を受け取る Tick でゲームスレッドが行う
+     * - タスクは登録したフレームのアクター Tick の終わり（と GC の前）に待つので、フレームや GC をまたがない
+     * - 結果は次の Tick で OnCylinderTraceBatchCompleted に通知され、
+     *   そのフレームの間は TryGetCylinderTraceBatchResults でも取得可能
+     */
+    UFUNCTION(BlueprintCallable, Category="CylinderTrace")
+    FCylinderTraceBatchHandle EnqueueCylinderTraceBatch(const TArray<FCylinderTraceRequest>& Requests);
+
+    /** 完了済みバッチの結果を取り出します（取り出した結果は破棄）。未完了・不明なら false。 */
+    UFUNCTION(BlueprintCallable, Category="CylinderTrace")
+    bool TryGetCylinderTraceBatchResults(FCylinderTraceBatchHandle Handle, TArray<FCylinderTraceResult>& OutResults);
+
+    /** バッチ完了通知（ゲームスレッド、完了の次の Tick） */
+    UPROPERTY(BlueprintAssignable, Category="CylinderTrace")
+    FOnCylinderTraceBatchCompleted OnCylinderTraceBatchCompleted;
+
+    /**
+     * フレーム間キャッシュ（時間的コヒーレンス）付きトレース用のハンドルを作ります。
+     *
+     * 同じハンドルで毎フレーム CylinderTraceCoherent を呼ぶと、前回の経路を InflationMargin だけ
+     * 膨らませた箱の中の候補プリミティブを覚えておき、経路がその箱に収まる間は候補だけを再スイープします。
+     * 箱からはみ出した・寸法が変わった時は通常のクエリで候補を集め直します。
+     *
+     * 注意: 候補収集後に箱の中へ入ってきた動的オブジェクトは、次の再収集まで検出されません。
+     * 静的寄りの環境や、マージンを超えたら再収集で十分な用途向けです。
+     */
+    UFUNCTION(BlueprintCallable, Category="CylinderTrace")
+    FCylinderTraceCoherenceHandle CreateCoherentTraceHandle(float InflationMargin = 50.0f);
+
+    UFUNCTION(BlueprintCallable, Category="CylinderTrace")
+    void ReleaseCoherentTraceHandle(FCylinderTraceCoherenceHandle Handle);
+
+    /** CylinderTraceStateless と同じ結果を、Handle の候補キャッシュを使って求めます（ゲームスレッド）。 */
+    UFUNCTION(BlueprintCallable, Category="CylinderTrace")
+    bool CylinderTraceCoherent(
+        FCylinderTraceCoherenceHandle Handle,
+        const FTransform& Transform,
+        float TraceDistance,
+        float Radius,
+        float HalfLength,
+        FName Tag,
+        EActorTagFilterMode FilterMode,
+        FHitResult& OutHit
+    );
+
 public:
     // UActorComponent / UPrimitiveComponent
     virtual void OnRegister() override;
+    virtual void OnUnregister() override;
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
     virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
     virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
     virtual UBodySetup* GetBodySetup() override;
 
 private:
-    UPROPERTY(Transient)
-    TObjectPtr<UBodySetup> BodySetup;
+    /** 共有のクック済み単位多角柱（角数が変わるまで保持） */
+    TSharedPtr<FCylinderPrismShape> PrismShape;
+
+private:
+    /** ワーカーに渡すバッチの中身（ゲームスレッドが所有し、タスクの完了を待ってから解放する） */
+    struct FTraceBatchWork
+    {
+        FCylinderTraceQueryContext Context;
+        TArray<FCylinderTraceRequest> Requests;
+
+        /** 要求ごとのクエリパラメータ（タグの事前絞り込みを適用済み） */
+        TArray<FCollisionQueryParams> QueryParams;
+
+        /** 事前絞り込みでスイープ不要と分かった要求 */
+        TBitArray<> Skipped;
+
+        /** 要求ごとの経路上の全ヒット（ExactCylinder では外接カプセルの候補）。ワーカーが書く */
+        TArray<TArray<FHitResult>> PathHits;
+    };
+
+    struct FPendingTraceBatch
+    {
+        int32 Id = 0;
+        UE::Tasks::FTask Task;
+        TUniquePtr<FTraceBatchWork> Work;
+    };
+
+    TArray<FPendingTraceBatch> PendingTraceBatches;
+
+    /** 直前の Tick で完了したバッチ（次の Tick で破棄） */
+    TMap<int32, TArray<FCylinderTraceResult>> CompletedTraceBatches;
+
+    int32 NextTraceBatchId = 1;
+
+    struct FCoherentTraceCandidate
+    {
+        TWeakObjectPtr<UPrimitiveComponent> Component;
+        int32 ItemIndex = INDEX_NONE;
+    };
+
+    struct FCoherentTraceCache
+    {
+        float InflationMargin = 0.0f;
 
-    int32 CachedNumSides = 0;
+        bool bValid = false;
+
+        /** 候補を集めた範囲（経路の包囲箱 + マージン） */
+        FBox InflatedBox = FBox(ForceInit);
+
+        /** 候補を集めた時の寸法（変わったら集め直し） */
+        float Radius = 0.0f;
+        float HalfLength = 0.0f;
+
+        TArray<FCoherentTraceCandidate> Candidates;
+    };
+
+    TMap<int32, FCoherentTraceCache> CoherentTraceCaches;
+
+    int32 NextCoherentTraceId = 1;
+
+    /** Cache.InflatedBox 内のプリミティブを集め直す */
+    void GatherCoherentTraceCandidates(const FCylinderTraceQueryContext& Context, const FBox& SweptBox, float Radius, float HalfLength, FCoherentTraceCache& Cache) const;
+
+    /** 完了済みのバッチの候補を判定して結果にする（ゲームスレッド） */
+    static void ResolveTraceBatch(const FTraceBatchWork& Work, TArray<FCylinderTraceResult>& OutResults);
+
+    /** 実行中のバッチのタスクを待つ（結果は次の Tick で通知） */
+    void FinishPendingTraceBatchTasks();
+
+    /** バッチのタスクを待ってから破棄（未通知の結果も捨てる） */
+    void WaitForPendingTraceBatches();
+
+    void HandleWorldPostActorTick(UWorld* InWorld, ELevelTick TickType, float DeltaSeconds);
+    void HandlePreGarbageCollect();
+
+    FDelegateHandle PostActorTickHandle;
+    FDelegateHandle PreGarbageCollectHandle;
 
 private:
-    void EnsureBodySetup();
+    /** CylinderTraceFromTransform の本体（記録の有無に関係しない部分） */
+    bool CylinderTraceFromTransformImpl(
+        const FTransform& Transform,
+        float TraceDistance,
+        float Radius,
+        float HalfLength,
+        FName Tag,
+        EActorTagFilterMode FilterMode,
+        FHitResult& OutHit
+    );
+
+    /** AActor::ActorHasTag で判定（索引は事前の絞り込みにだけ使う） */
+    static bool ShouldAcceptActorByTag(const AActor* Actor, FName Tag, EActorTagFilterMode Mode);
+
+    /** タグ索引からスナップショットを作る（ゲームスレッド）。索引が使えない・対象が MaxActors を超えるなら false。 */
+    static bool MakeTagSnapshot(const UWorld* World, FName Tag, int32 MaxActors, FCylinderTraceTagSnapshot& OutSnapshot);
 
-    bool ShouldAcceptActorByTag(const AActor* Actor, FName Tag, EActorTagFilterMode Mode) const;
+    /** Include 対象が経路（円柱の外接球を掃いた箱）に1つも掛からないか */
+    static bool IsTagSnapshotOutsideSweep(const FCylinderTraceTagSnapshot& Snapshot, const FVector& Start, const FVector& End, float Radius, float HalfLength);
 
     bool SweepOnce(
         const FVector& StartCenter,
@@ -96,4 +543,154 @@ private:
         const FQuat& Rotation,
         FHitResult& OutHit
     );
+
+    /** MaxDeviationCm 用のプリセット角数の形状（角数 → 形状。ゲームスレッドでだけ書き換え、クエリは読むだけ） */
+    TMap<int32, TSharedPtr<FCylinderPrismShape>> DeviationPrismShapes;
+
+    /** MaxDeviationCm が有効なら全プリセット角数の形状を用意し、無効なら放す（ゲームスレッド） */
+    void UpdateDeviationPrismShapes();
+
+    /** 半径に対して使う多角柱（MaxDeviation 無効なら Context.Shape） */
+    static const FCylinderPrismShape* ResolvePrismShape(const FCylinderTraceQueryContext& Context, float Radius);
+
+    /** ResolvePrismShape の多角柱を Scale の寸法にした Implicit（形状が未構築なら false） */
+    static bool MakeScaledPrism(const FCylinderTraceQueryContext& Context, const FVector& Scale, TOptional<Chaos::TImplicitObjectScaled<Chaos::FConvex>>& OutScaledPrism);
+
+    /**
+     * 現在の衝突設定・形状と、Tags の索引からクエリ条件のスナップショットを作る。
+     * MaxDeviationCm が有効なら Radii の半径で使う角数の形状も載せる（用意済みのものを読むだけ）。
+     * タグ索引のスナップショットはゲームスレッドで呼ばれた時だけ作る。
+     */
+    FCylinderTraceQueryContext MakeQueryContext(const TArray<FName>& Tags, TConstArrayView<float> Radii) const;
+
+    /** スナップショットを使う円柱トレース（ゲームスレッド。ヒットした Actor のタグ・応答を参照する） */
+    static bool TraceWithContext(const FCylinderTraceQueryContext& Context, const FCylinderTraceRequest& Request, FHitResult& OutHit);
+
+    /** 状態を持たないマルチヒットスイープ1回分（時間順）。 */
+    static void SweepConvexMulti(
+        const FCylinderTraceQueryContext& Context,
+        const FVector& StartCenter,
+        const FVector& EndCenter,
+        const FQuat& Rotation,
+        const FVector& Scale,
+        const FCollisionQueryParams& QueryParams,
+        const FCollisionResponseParams& ResponseParams,
+        TArray<FHitResult>& OutHits
+    );
+
+    /**
+     * 解析的な円柱のマルチヒットスイープ（時間順、応答によらず経路上の全ヒット）。
+     * 外接カプセルで候補を集め、候補のシェイプごとに円柱で再スイープします。
+     */
+    static void SweepExactCylinderMulti(
+        const FCylinderTraceQueryContext& Context,
+        const FVector& StartCenter,
+        const FVector& EndCenter,
+        const FQuat& Rotation,
+        float Radius,
+        float HalfLength,
+        const FCollisionQueryParams& QueryParams,
+        TArray<FHitResult>& OutHits
+    );
+
+    /** 円柱を包む外接カプセルで、応答によらず経路上の候補を集める（シーンクエリのみ。ワーカーから可） */
+    static void GatherExactCylinderCandidates(
+        const FCylinderTraceQueryContext& Context,
+        const FVector& StartCenter,
+        const FVector& EndCenter,
+        const FQuat& Rotation,
+        float Radius,
+        float HalfLength,
+        const FCollisionQueryParams& QueryParams,
+        TArray<FHitResult>& OutCandidates
+    );
+
+    /**
+     * 候補を円柱で判定し、当たったものだけ時間順に返す（ヒットしたコンポーネントのボディを参照するのでゲームスレッド）。
+     * 判定はボディ（コンポーネント・Item・ボーン）ごとに1回。凸でない相手には Context の多角柱を使う。
+     */
+    static void RefineExactCylinderCandidates(
+        const FCylinderTraceQueryContext& Context,
+        const TArray<FHitResult>& Candidates,
+        const FVector& StartCenter,
+        const FVector& EndCenter,
+        const FQuat& Rotation,
+        float Radius,
+        float HalfLength,
+        TArray<FHitResult>& OutHits
+    );
+
+    /**
+     * 候補1件のボディを円柱で判定。当たれば Candidate を元に時刻・位置・法線を更新して true。
+     * 凸でないシェイプは NonConvexStandIn で判定（nullptr なら判定しない）。
+     */
+    static bool SweepExactCylinderAgainst(
+        const FHitResult& Candidate,
+        const Chaos::FCylinder& Cylinder,
+        const Chaos::TImplicitObjectScaled<Chaos::FConvex>* NonConvexStandIn,
+        const FVector& StartCenter,
+        const FVector& EndCenter,
+        const FQuat& Rotation,
+        FHitResult& OutHit
+    );
+
+    /**
+     * タグ索引で事前に絞り込む。Exclude 対象は QueryParams の無視リストに追加。
+     * Include 対象が経路に1つも無ければ false（スイープ不要）。
+     */
+    static bool ApplyTagPrefilter(
+        const FCylinderTraceQueryContext& Context,
+        const FCylinderTraceRequest& Request,
+        const FVector& StartCenter,
+        const FVector& EndCenter,
+        FCollisionQueryParams& QueryParams
+    );
+
+    /** 応答によらず経路上の全ヒットを時間順に集める（ShapeMode に応じた形状で1回スイープ） */
+    static void CollectPathHits(
+        const FCylinderTraceQueryContext& Context,
+        const FVector& StartCenter,
+        const FVector& EndCenter,
+        const FQuat& Rotation,
+        const FVector& Scale,
+        const FCollisionQueryParams& QueryParams,
+        TArray<FHitResult>& OutHits
+    );
+
+    /** 時間順のヒットから、本来ブロックしタグ条件も満たす最初のヒットを選ぶ */
+    static bool SelectFirstAcceptedHit(
+        const FCylinderTraceQueryContext& Context,
+        const TArray<FHitResult>& Hits,
+        FName Tag,
+        EActorTagFilterMode FilterMode,
+        FHitResult& OutHit
+    );
+
+    /** 1回のマルチヒットスイープで、本来ブロックしタグ条件も満たす最初のヒットを返す。 */
+    static bool SweepSinglePassFiltered(
+        const FCylinderTraceQueryContext& Context,
+        const FVector& StartCenter,
+        const FVector& EndCenter,
+        const FQuat& Rotation,
+        const FVector& Scale,
+        const FCollisionQueryParams& QueryParams,
+        FName Tag,
+        EActorTagFilterMode FilterMode,
+        FHitResult& OutHit
+    );
+
+    /** このコンポーネントと Hit 相手の応答から、本来ブロックするヒットか判定 */
+    static bool IsBlockingResponse(const FCylinderTraceQueryContext& Context, const FHitResult& Hit);
+
+    /** 状態を持たないスイープ1回分。最初のブロッキングヒットを返す。 */
+    static bool SweepConvexOnce(
+        const FCylinderTraceQueryContext& Context,
+        const FVector& StartCenter,
+        const FVector& EndCenter,
+        const FQuat& Rotation,
+        const FVector& Scale,
+        const FCollisionQueryParams& QueryParams,
+        const FCollisionResponseParams& ResponseParams,
+        FHitResult& OutHit
+    );
 };
\ No newline at end of file
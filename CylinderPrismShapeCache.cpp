@@ -0,0 +1,179 @@
+#include "CylinderPrismShapeCache.h"
+
+#include "CylinderPrismShapeLibrary.h"
+#include "PhysicsEngine/AggregateGeom.h"
+#include "PhysicsEngine/ConvexElem.h"
+#include "UObject/Package.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/DelayedAutoRegister.h"
+
+namespace
+{
+    // 初回の FindOrCreate で同期ロードしないよう起動時に読み込み、static の破棄（UObject の終了後）より前に放す
+    FDelayedAutoRegisterHelper GCylinderPrismShapeLibraryRegistration(EDelayedRegisterRunPhase::EndOfEngineInit, []
+    {
+        FCylinderPrismShapeCache::ReloadPrecookedLibrary();
+        FCoreDelegates::OnEnginePreExit.AddStatic(&FCylinderPrismShapeCache::ReleasePrecookedLibrary);
+    });
+}
+
+FCylinderPrismShape::FCylinderPrismShape(const int32 InNumSides)
+    : NumSides(FCylinderPrismShapeCache::ClampNumSides(InNumSides))
+{
+    check(IsInGameThread());
+
+    // 特定コンポーネントに属さないよう TransientPackage に作り、StrongPtr で GC から守る
+    BodySetup.Reset(NewObject<UBodySetup>(GetTransientPackage(), NAME_None, RF_Transient));
+    BuildUnitPrism(*BodySetup, NumSides);
+
+    // クックはこの角数で1回だけ
+    BodySetup->CreatePhysicsMeshes();
+}
+
+FCylinderPrismShape::FCylinderPrismShape(const int32 InNumSides, UBodySetup* InPrecookedBodySetup)
+    : NumSides(FCylinderPrismShapeCache::ClampNumSides(InNumSides))
+{
+    check(IsInGameThread());
+    check(InPrecookedBodySetup);
+
+    BodySetup.Reset(InPrecookedBodySetup);
+
+    // パッケージ版ではクック済みデータから Convex を作るだけ（ハル計算はしない）
+    if (!IsCooked())
+    {
+        BodySetup->CreatePhysicsMeshes();
+    }
+}
+
+void FCylinderPrismShape::BuildUnitPrism(UBodySetup& InBodySetup, const int32 InNumSides)
+{
+    const int32 Sides = FCylinderPrismShapeCache::ClampNumSides(InNumSides);
+
+    InBodySetup.bGenerateMirroredCollision = false;
+    InBodySetup.bDoubleSidedGeometry = false;
+
+    // Simple(Convex) をクエリに使う
+    InBodySetup.CollisionTraceFlag = ECollisionTraceFlag::CTF_UseSimpleAsComplex;
+
+    // 単位多角柱：
+    // - 半径 1（XY）
+    // - 高さ 1（Z: -0.5..+0.5）
+    const float Radius = 1.0f;
+    const float HalfHeight = 0.5f;
+
+    TArray<FVector> Verts;
+    Verts.Reserve(Sides * 2);
+
+    for (int32 i = 0; i < Sides; ++i)
+    {
+        const float A = (2.0f * PI) * (static_cast<float>(i) / static_cast<float>(Sides));
+        const float X = FMath::Cos(A) * Radius;
+        const float Y = FMath::Sin(A) * Radius;
+
+        Verts.Add(FVector(X, Y, -HalfHeight)); // bottom
+        Verts.Add(FVector(X, Y, +HalfHeight)); // top
+    }
+
+    FKConvexElem Convex;
+    Convex.VertexData = MoveTemp(Verts);
+    Convex.UpdateElemBox();
+
+    InBodySetup.AggGeom.ConvexElems.Reset();
+    InBodySetup.AggGeom.ConvexElems.Add(MoveTemp(Convex));
+    InBodySetup.InvalidatePhysicsData();
+}
+
+bool FCylinderPrismShape::IsCooked() const
+{
+    return BodySetup.IsValid()
+        && BodySetup->AggGeom.ConvexElems.Num() == 1
+        && BodySetup->AggGeom.ConvexElems[0].GetChaosConvexMesh() != nullptr;
+}
+
+TMap<int32, TWeakPtr<FCylinderPrismShape>>& FCylinderPrismShapeCache::GetShapes()
+{
+    static TMap<int32, TWeakPtr<FCylinderPrismShape>> Shapes;
+    return Shapes;
+}
+
+TSharedRef<FCylinderPrismShape> FCylinderPrismShapeCache::FindOrCreate(const int32 NumSides)
+{
+    check(IsInGameThread());
+
+    const int32 ClampedSides = ClampNumSides(NumSides);
+
+    TWeakPtr<FCylinderPrismShape>& Slot = GetShapes().FindOrAdd(ClampedSides);
+    if (TSharedPtr<FCylinderPrismShape> Existing = Slot.Pin())
+    {
+        return Existing.ToSharedRef();
+    }
+
+    UBodySetup* Precooked = nullptr;
+    if (const UCylinderPrismShapeLibrary* Library = GetPrecookedLibrary().Get())
+    {
+        Precooked = Library->FindBodySetup(ClampedSides);
+    }
+
+    TSharedRef<FCylinderPrismShape> Shape = Precooked
+        ? MakeShared<FCylinderPrismShape>(ClampedSides, Precooked)
+        : MakeShared<FCylinderPrismShape>(ClampedSides);
+    Slot = Shape;
+    return Shape;
+}
+
+TStrongObjectPtr<UCylinderPrismShapeLibrary>& FCylinderPrismShapeCache::GetPrecookedLibrary()
+{
+    static TStrongObjectPtr<UCylinderPrismShapeLibrary> Library;
+    return Library;
+}
+
+void FCylinderPrismShapeCache::ReloadPrecookedLibrary()
+{
+    check(IsInGameThread());
+
+    UCylinderPrismShapeLibrary* Library = nullptr;
+    if (const UCylinderPrismShapeSettings* Settings = GetDefault<UCylinderPrismShapeSettings>())
+    {
+        Library = Settings->ShapeLibrary.LoadSynchronous();
+    }
+    GetPrecookedLibrary().Reset(Library);
+
+    // 古いライブラリ・実行時クックの形状を次の取得で返さないよう外す（使用中のものは参照が外れるまで残る）
+    GetShapes().Reset();
+}
+
+void FCylinderPrismShapeCache::ReleasePrecookedLibrary()
+{
+    GetPrecookedLibrary().Reset();
+}
+
+TConstArrayView<int32> FCylinderPrismShapeCache::GetPresetNumSides()
+{
+    static const int32 Presets[] = { 3, 4, 6, 8, 12, 16, 24, 32, 48, 64, 96, 128 };
+    return Presets;
+}
+
+int32 FCylinderPrismShapeCache::SelectNumSidesForDeviation(const float Radius, const float MaxDeviation)
+{
+    const TConstArrayView<int32> Presets = GetPresetNumSides();
+
+    if (Radius <= KINDA_SMALL_NUMBER || MaxDeviation >= Radius)
+    {
+        return Presets[0];
+    }
+    if (MaxDeviation <= KINDA_SMALL_NUMBER)
+    {
+        return Presets.Last();
+    }
+
+    const float RequiredSides = PI / FMath::Acos(1.0f - MaxDeviation / Radius);
+
+    for (const int32 Sides : Presets)
+    {
+        if (Sides >= RequiredSides)
+        {
+            return Sides;
+        }
+    }
+    return Presets.Last();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/StrongObjectPtr.h"
+#include "PhysicsEngine/BodySetup.h"
+
+class UCylinderPrismShapeLibrary;
+
+/**
+ * クック済みの単位N角柱（半径1・高さ1、Z軸が高さ方向）。
+ *
+ * - 角数ごとにプロセス内で1つだけ生成し、参照する全コンポーネントで共有
+ * - 寸法はスケールで与える前提（UCylinderConvexTraceComponent と同じ）
+ * - 最後の参照が外れた時点で UBodySetup も解放（ゲームスレッドで解放すること）
+ */
+class FCylinderPrismShape
+{
+public:
+    /** 頂点を作ってその場でクック */
+    explicit FCylinderPrismShape(int32 InNumSides);
+
+    /** UCylinderPrismShapeLibrary 内の形状を共有（クック済みデータから Convex を作るだけ） */
+    FCylinderPrismShape(int32 InNumSides, UBodySetup* InPrecookedBodySetup);
+
+    /** BodySetup に単位N角柱の Convex を設定（クックはしない）。実行時生成とライブラリ作成で共通。 */
+    static void BuildUnitPrism(UBodySetup& InBodySetup, int32 InNumSides);
+
+    int32 GetNumSides() const { return NumSides; }
+
+    UBodySetup* GetBodySetup() const { return BodySetup.Get(); }
+
+    /** クエリに使える Convex が1つだけ存在するか */
+    bool IsCooked() const;
+
+private:
+    int32 NumSides = 0;
+
+    TStrongObjectPtr<UBodySetup> BodySetup;
+};
+
+/**
+ * FCylinderPrismShape の角数キーのキャッシュ（プロセス全体で共有）。
+ * 取得・生成はゲームスレッドのみ。保持は弱参照なので、使われなくなった角数は自動で消えます。
+ * プロジェクト設定の UCylinderPrismShapeLibrary に収録済みの角数はそれを使い、実行時にクックしません。
+ * ライブラリはエンジン初期化の最後に読み込み、エンジン終了処理の前に放します（FindOrCreate では読み込まない）。
+ */
+class FCylinderPrismShapeCache
+{
+public:
+    /** 角数は 3〜128 にクランプされます。 */
+    static TSharedRef<FCylinderPrismShape> FindOrCreate(int32 NumSides);
+
+    static int32 ClampNumSides(int32 NumSides) { return FMath::Clamp(NumSides, 3, 128); }
+
+    /** 許容誤差から角数を選ぶ時の候補（昇順）。クックする形状の種類をこの数に抑えるため固定。 */
+    static TConstArrayView<int32> GetPresetNumSides();
+
+    /**
+     * 半径 Radius の円からのずれが MaxDeviation 以下になる最小のプリセット角数。
+     * 頂点は円周上にあるので最大のずれは辺の中点で R(1 - cos(π/N))、よって N >= π / acos(1 - MaxDeviation/R)。
+     * 最大のプリセットでも足りない場合はそれを返します。
+     */
+    static int32 SelectNumSidesForDeviation(float Radius, float MaxDeviation);
+
+    /**
+     * 設定のライブラリを読み込み直して保持する（ゲームスレッドのみ）。
+     * 以降の FindOrCreate は新しいライブラリから作る（取得済みの形状はそのまま使える）。
+     * 設定の変更・RebuildPresets の後にも呼ばれます。
+     */
+    static void ReloadPrecookedLibrary();
+
+    /** 保持しているライブラリを放す（UObject の終了処理より前に呼ぶこと） */
+    static void ReleasePrecookedLibrary();
+
+private:
+    static TMap<int32, TWeakPtr<FCylinderPrismShape>>& GetShapes();
+
+    /** 読み込み済みの設定のライブラリ。未指定・未読み込みなら空 */
+    static TStrongObjectPtr<UCylinderPrismShapeLibrary>& GetPrecookedLibrary();
+};
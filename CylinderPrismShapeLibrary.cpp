@@ -0,0 +1,71 @@
+#include "CylinderPrismShapeLibrary.h"
+
+#include "CylinderPrismShapeCache.h"
+#include "UObject/Package.h"
+
+FPrimaryAssetId UCylinderPrismShapeLibrary::GetPrimaryAssetId() const
+{
+    return FPrimaryAssetId(TEXT("CylinderPrismShapeLibrary"), GetFName());
+}
+
+UBodySetup* UCylinderPrismShapeLibrary::FindBodySetup(const int32 NumSides) const
+{
+    for (const FCylinderPrismShapeEntry& Entry : Shapes)
+    {
+        if (Entry.NumSides == NumSides)
+        {
+            return Entry.BodySetup;
+        }
+    }
+    return nullptr;
+}
+
+#if WITH_EDITOR
+void UCylinderPrismShapeLibrary::RebuildPresets()
+{
+    Modify();
+
+    // 使用中の FCylinderPrismShape が古い形状を保持していることがあるので、同じ名前で置き換えず
+    // Transient パッケージへ移してから作り直す（参照が外れれば GC で消える）
+    for (const FCylinderPrismShapeEntry& Entry : Shapes)
+    {
+        if (Entry.BodySetup)
+        {
+            Entry.BodySetup->Rename(nullptr, GetTransientPackage(), REN_DontCreateRedirectors);
+        }
+    }
+    Shapes.Reset();
+
+    for (const int32 Sides : FCylinderPrismShapeCache::GetPresetNumSides())
+    {
+        // アセットの中に保存するので Outer は this（Transient にしない）
+        UBodySetup* BodySetup = NewObject<UBodySetup>(this, *FString::Printf(TEXT("Prism%d"), Sides));
+        FCylinderPrismShape::BuildUnitPrism(*BodySetup, Sides);
+
+        // エディタ上でもすぐ使えるようにクック（パッケージ版はクック時に保存したデータを使う）
+        BodySetup->CreatePhysicsMeshes();
+
+        FCylinderPrismShapeEntry& Entry = Shapes.AddDefaulted_GetRef();
+        Entry.NumSides = Sides;
+        Entry.BodySetup = BodySetup;
+    }
+
+    MarkPackageDirty();
+
+    // 設定で使われているライブラリなら、作り直した形状を次の取得から使う
+    if (GetDefault<UCylinderPrismShapeSettings>()->ShapeLibrary.Get() == this)
+    {
+        FCylinderPrismShapeCache::ReloadPrecookedLibrary();
+    }
+}
+
+void UCylinderPrismShapeSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+
+    if (PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(UCylinderPrismShapeSettings, ShapeLibrary))
+    {
+        FCylinderPrismShapeCache::ReloadPrecookedLibrary();
+    }
+}
+#endif
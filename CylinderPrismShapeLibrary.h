@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Engine/DeveloperSettings.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "CylinderPrismShapeLibrary.generated.h"
+
+USTRUCT()
+struct FCylinderPrismShapeEntry
+{
+    GENERATED_BODY()
+
+    UPROPERTY(VisibleAnywhere, Category="CylinderPrism")
+    int32 NumSides = 0;
+
+    /** 単位N角柱（FCylinderPrismShape と同じ形状）。クック時に Convex のクック済みデータも一緒に保存される */
+    UPROPERTY(VisibleAnywhere, Instanced, Category="CylinderPrism")
+    TObjectPtr<UBodySetup> BodySetup;
+};
+
+/**
+ * エディタで作っておく単位N角柱のセット。
+ *
+ * - パッケージ版ではクック済みの Convex データを読むだけなので、ロード中にゲームスレッドでクックしない
+ * - 中身は RebuildPresets（エディタのボタン）で FCylinderPrismShapeCache::GetPresetNumSides() 分を作り直す
+ * - 使うには UCylinderPrismShapeSettings::ShapeLibrary（プロジェクト設定）に指定し、クック対象にも加える
+ *   （プライマリアセット型 "CylinderPrismShapeLibrary"。UCylinderPrismShapeSettings のコメント参照）
+ */
+UCLASS(BlueprintType)
+class UCylinderPrismShapeLibrary : public UDataAsset
+{
+    GENERATED_BODY()
+
+public:
+    /** アセットマネージャのルールでクック対象にできるよう、プライマリアセットとして扱う */
+    virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+
+    /** NumSides の形状（無ければ nullptr） */
+    UBodySetup* FindBodySetup(int32 NumSides) const;
+
+#if WITH_EDITOR
+    /** プリセット角数の形状を作り直す（頂点の生成は実行時のクックと共通） */
+    UFUNCTION(CallInEditor, Category="CylinderPrism")
+    void RebuildPresets();
+#endif
+
+private:
+    UPROPERTY(VisibleAnywhere, Category="CylinderPrism")
+    TArray<FCylinderPrismShapeEntry> Shapes;
+};
+
+/**
+ * 円柱トレースのプロジェクト設定。
+ *
+ * ShapeLibrary は Config のソフト参照で、クッカーは辿らないため、そのままではパッケージに入らず
+ * パッケージ版は実行時のクックに戻ります（エラーにはならない）。DefaultGame.ini でクック対象に加えること:
+ *
+ *   [/Script/Engine.AssetManagerSettings]
+ *   +PrimaryAssetTypesToScan=(PrimaryAssetType="CylinderPrismShapeLibrary",AssetBaseClass="/Script/<Module>.CylinderPrismShapeLibrary",bHasBlueprintClasses=False,bIsEditorOnly=False,Directories=((Path="/Game/<ライブラリのフォルダ>")),Rules=(CookRule=AlwaysCook))
+ *
+ * （または [/Script/UnrealEd.ProjectPackagingSettings] の +DirectoriesToAlwaysCook でライブラリのフォルダを指定）
+ */
+UCLASS(Config=Game, DefaultConfig, meta=(DisplayName="Cylinder Trace"))
+class UCylinderPrismShapeSettings : public UDeveloperSettings
+{
+    GENERATED_BODY()
+
+public:
+    /** 事前クック済みの角柱形状。未指定・未収録の角数は実行時にクックします */
+    UPROPERTY(Config, EditAnywhere, Category="CylinderPrism")
+    TSoftObjectPtr<UCylinderPrismShapeLibrary> ShapeLibrary;
+
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+};
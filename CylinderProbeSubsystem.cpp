@@ -0,0 +1,443 @@
+#include "CylinderProbeSubsystem.h"
+
+#include "Components/PrimitiveComponent.h"
+#include "PhysicsEngine/AggregateGeom.h"
+#include "PhysicsEngine/ConvexElem.h"
+#include "PhysicsEngine/BodyInstance.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "Physics/Experimental/ChaosInterfaceWrapper.h"
+#include "CollisionQueryFilterCallbackCore.h"
+#include "SQAccelerator.h"
+#include "PBDRigidsSolver.h"
+#include "Chaos/SimCallbackObject.h"
+#include "Chaos/SimCallbackInput.h"
+#include "Chaos/Convex.h"
+#include "Chaos/ImplicitObjectScaled.h"
+#include "Chaos/ParticleHandle.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+#include "Engine/World.h"
+
+namespace
+{
+    /** 物理スレッドへ渡すプローブ1つ分（ゲームスレッドのオブジェクトは参照しない） */
+    struct FCylinderProbeState
+    {
+        int32 Id = INDEX_NONE;
+        FTransform LocalTransform;
+        float TraceDistance = 0.0f;
+        float Radius = 0.0f;
+        float HalfLength = 0.0f;
+        ECollisionChannel Channel = ECC_Visibility;
+
+        /** 単位多角柱。物理スレッドが使っている間に BodySetup が解放されても残るよう Convex 自体を保持 */
+        TSharedPtr<Chaos::FConvex, ESPMode::ThreadSafe> Convex;
+
+        /** 追従先のボディ（無ければワールド基準）。登録解除が届いたら物理スレッドで外す */
+        Chaos::FSingleParticlePhysicsProxy* AttachedProxy = nullptr;
+
+        /** 追従先が登録解除された（ワールド基準には戻さず、送り直されるまで評価しない） */
+        bool bAttachedProxyLost = false;
+
+        TSharedPtr<UCylinderProbeSubsystem::FResultBuffer, ESPMode::ThreadSafe> Results;
+
+        /** 物理スレッド側の評価回数 */
+        int32 Sequence = 0;
+    };
+
+    /** 指定 Trace チャンネルを Block するシェイプだけ通す（追従先のボディ自身は除外） */
+    class FCylinderProbeFilterCallback : public ICollisionQueryFilterCallbackBase
+    {
+    public:
+        FCylinderProbeFilterCallback(const ECollisionChannel InChannel, const Chaos::FGeometryParticleHandle* InIgnoreParticle)
+            : ChannelBit(ECC_TO_BITFIELD(InChannel))
+            , IgnoreParticle(InIgnoreParticle)
+        {
+        }
+
+        virtual ECollisionQueryHitType PreFilter(const FCollisionFilterData&, const Chaos::FPerShapeData&, const Chaos::FGeometryParticle&) override
+        {
+            // 外部スレッド側のパーティクルでは呼ばれない
+            return ECollisionQueryHitType::None;
+        }
+
+        virtual ECollisionQueryHitType PreFilter(const FCollisionFilterData&, const Chaos::FPerShapeData& Shape, const Chaos::FGeometryParticleHandle& Actor) override
+        {
+            if (&Actor == IgnoreParticle)
+            {
+                return ECollisionQueryHitType::None;
+            }
+
+            // Word1 = Trace チャンネルごとの Block ビット
+            return (Shape.GetQueryData().Word1 & ChannelBit) != 0
+                ? ECollisionQueryHitType::Block
+                : ECollisionQueryHitType::None;
+        }
+
+        virtual ECollisionQueryHitType PostFilter(const FCollisionFilterData&, const ChaosInterface::FQueryHit&) override
+        {
+            return ECollisionQueryHitType::Block;
+        }
+
+        virtual ECollisionQueryHitType PostFilter(const FCollisionFilterData&, const ChaosInterface::FPTQueryHit&) override
+        {
+            return ECollisionQueryHitType::Block;
+        }
+
+    private:
+        uint32 ChannelBit = 0;
+        const Chaos::FGeometryParticleHandle* IgnoreParticle = nullptr;
+    };
+}
+
+struct FCylinderProbeSimInput : public Chaos::FSimCallbackInput
+{
+    /** bHasProbes の時だけ Probes で全置き換え（変更が無いフレームは空のまま） */
+    TArray<FCylinderProbeState> Probes;
+    bool bHasProbes = false;
+
+    void Reset()
+    {
+        Probes.Reset();
+        bHasProbes = false;
+    }
+};
+
+struct FCylinderProbeSimOutput : public Chaos::FSimCallbackOutput
+{
+    void Reset() {}
+};
+
+/** サブステップごと（OnPreSimulate_Internal）に全プローブを評価する */
+class FCylinderProbeSimCallback : public Chaos::TSimCallbackObject<FCylinderProbeSimInput, FCylinderProbeSimOutput>
+{
+public:
+    FCylinderProbeSimCallback()
+        : TSimCallbackObject(Chaos::ESimCallbackOptions::Presimulate | Chaos::ESimCallbackOptions::ParticleUnregister)
+    {
+    }
+
+private:
+    virtual void OnPreSimulate_Internal() override;
+
+    /** 追従先のプロキシが解放される前に外す（物理スレッド） */
+    virtual void OnParticleUnregistered_Internal(TArray<TTuple<Chaos::FUniqueIdx, Chaos::FSingleParticlePhysicsProxy*>>& UnregisteredProxies) override;
+
+    void DetachUnregisteredProxies();
+
+    void EvaluateProbe(const FChaosSQAccelerator& Accelerator, FCylinderProbeState& Probe, float SimTime) const;
+
+    /** 物理スレッド側の登録内容（物理スレッドのみが触る） */
+    TArray<FCylinderProbeState> Probes;
+
+    /**
+     * 前回の OnPreSimulate_Internal 以降に登録解除されたプロキシ。
+     * 同じフレームにゲームスレッドから送られた入力がまだ古いポインタを持っていることがあるので、入力を取り込んだ後にも外す
+     */
+    TSet<const Chaos::FSingleParticlePhysicsProxy*> UnregisteredProxies;
+};
+
+void FCylinderProbeSimCallback::OnParticleUnregistered_Internal(TArray<TTuple<Chaos::FUniqueIdx, Chaos::FSingleParticlePhysicsProxy*>>& InUnregisteredProxies)
+{
+    for (const TTuple<Chaos::FUniqueIdx, Chaos::FSingleParticlePhysicsProxy*>& Pair : InUnregisteredProxies)
+    {
+        UnregisteredProxies.Add(Pair.Get<1>());
+    }
+    DetachUnregisteredProxies();
+}
+
+void FCylinderProbeSimCallback::DetachUnregisteredProxies()
+{
+    if (UnregisteredProxies.Num() == 0)
+    {
+        return;
+    }
+
+    for (FCylinderProbeState& Probe : Probes)
+    {
+        if (Probe.AttachedProxy && UnregisteredProxies.Contains(Probe.AttachedProxy))
+        {
+            Probe.AttachedProxy = nullptr;
+            Probe.bAttachedProxyLost = true;
+        }
+    }
+}
+
+void FCylinderProbeSimCallback::OnPreSimulate_Internal()
+{
+    if (const FCylinderProbeSimInput* Input = GetConsumerInput_Internal())
+    {
+        if (Input->bHasProbes)
+        {
+            // 評価回数は Id で引き継ぐ
+            TMap<int32, int32> PrevSequences;
+            for (const FCylinderProbeState& Probe : Probes)
+            {
+                PrevSequences.Add(Probe.Id, Probe.Sequence);
+            }
+
+            Probes = Input->Probes;
+            for (FCylinderProbeState& Probe : Probes)
+            {
+                if (const int32* Sequence = PrevSequences.Find(Probe.Id))
+                {
+                    Probe.Sequence = *Sequence;
+                }
+            }
+        }
+    }
+
+    // 取り込んだ入力が既に解除されたプロキシを指していないか。次に届く入力はゲームスレッドで外れた後のもの
+    DetachUnregisteredProxies();
+    UnregisteredProxies.Reset();
+
+    if (Probes.Num() == 0)
+    {
+        return;
+    }
+
+    const Chaos::FPBDRigidsSolver* Solver = static_cast<const Chaos::FPBDRigidsSolver*>(GetSolver());
+    const auto* AccelerationStructure = Solver ? Solver->GetInternalAccelerationStructure_Internal() : nullptr;
+    if (!AccelerationStructure)
+    {
+        return;
+    }
+
+    const FChaosSQAccelerator Accelerator(*AccelerationStructure);
+    const float SimTime = static_cast<float>(GetSimTime_Internal());
+
+    for (FCylinderProbeState& Probe : Probes)
+    {
+        EvaluateProbe(Accelerator, Probe, SimTime);
+    }
+}
+
+void FCylinderProbeSimCallback::EvaluateProbe(const FChaosSQAccelerator& Accelerator, FCylinderProbeState& Probe, const float SimTime) const
+{
+    FTransform ProbeTransform = Probe.LocalTransform;
+    const Chaos::FGeometryParticleHandle* IgnoreParticle = nullptr;
+
+    if (Probe.bAttachedProxyLost)
+    {
+        return;
+    }
+
+    if (Probe.AttachedProxy)
+    {
+        // 追従先の現在のサブステップ姿勢
+        Chaos::FRigidBodyHandle_Internal* Body = Probe.AttachedProxy->GetPhysicsThreadAPI();
+        if (!Body)
+        {
+            return;
+        }
+        ProbeTransform = Probe.LocalTransform * FTransform(Body->R(), Body->X());
+        IgnoreParticle = Probe.AttachedProxy->GetHandle_LowLevel();
+    }
+
+    const FVector Dir = -ProbeTransform.GetUnitAxis(EAxis::Z); // ローカルZ-方向
+    const FTransform StartTM(ProbeTransform.GetRotation(), ProbeTransform.GetLocation());
+
+    const Chaos::TImplicitObjectScaled<Chaos::FConvex> ScaledConvex(
+        Probe.Convex, FVector(Probe.Radius, Probe.Radius, 2.0f * Probe.HalfLength));
+
+    FCylinderProbeFilterCallback FilterCallback(Probe.Channel, IgnoreParticle);
+    const ChaosInterface::FQueryFilterData FilterData(FCollisionFilterData(), ChaosInterface::EQueryFlags::PreFilter);
+
+    ChaosInterface::FSingleHitBuffer<ChaosInterface::FPTSweepHit> HitBuffer;
+    Accelerator.Sweep(
+        ScaledConvex,
+        StartTM,
+        Dir,
+        Probe.TraceDistance,
+        HitBuffer,
+        EHitFlags::Distance | EHitFlags::Position | EHitFlags::Normal,
+        FilterData,
+        FilterCallback
+    );
+
+    FCylinderProbeResult Result;
+    Result.ProbeTransform = ProbeTransform;
+    Result.SimTime = SimTime;
+    Result.Sequence = ++Probe.Sequence;
+    Result.Distance = Probe.TraceDistance;
+
+    if (HitBuffer.HasBlockingHit())
+    {
+        const ChaosInterface::FPTSweepHit& Hit = *HitBuffer.GetBlock();
+        Result.bHit = true;
+        Result.Distance = Hit.Distance;
+        Result.ImpactPoint = Hit.WorldPosition;
+        Result.ImpactNormal = Hit.WorldNormal;
+    }
+
+    Probe.Results->Write(Result);
+}
+
+void UCylinderProbeSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+    Super::Initialize(Collection);
+
+    UWorld* World = GetWorld();
+    FPhysScene* PhysScene = World ? World->GetPhysicsScene() : nullptr;
+    if (Chaos::FPhysicsSolver* Solver = PhysScene ? PhysScene->GetSolver() : nullptr)
+    {
+        SimCallback = Solver->CreateAndRegisterSimCallbackObject_External<FCylinderProbeSimCallback>();
+    }
+}
+
+void UCylinderProbeSubsystem::Deinitialize()
+{
+    if (SimCallback)
+    {
+        // 物理スレッドでの解放はソルバ側が面倒を見る（実行中のサブステップが終わってから）
+        if (Chaos::FPhysicsSolver* Solver = static_cast<Chaos::FPhysicsSolver*>(SimCallback->GetSolver()))
+        {
+            Solver->UnregisterAndFreeSimCallbackObject_External(SimCallback);
+        }
+        SimCallback = nullptr;
+    }
+
+    Probes.Reset();
+
+    Super::Deinitialize();
+}
+
+void UCylinderProbeSubsystem::Tick(const float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    // 追従先のボディが消えた・作り直されたプローブは送り直す（古い物理ハンドルを物理スレッドに残さない）
+    for (auto& Pair : Probes)
+    {
+        FRegisteredProbe& Probe = Pair.Value;
+        if (!Probe.Desc.AttachTo.IsExplicitlyNull())
+        {
+            const UPrimitiveComponent* AttachTo = Probe.Desc.AttachTo.Get();
+            const FBodyInstance* BodyInstance = AttachTo ? AttachTo->GetBodyInstance() : nullptr;
+            const void* Handle = BodyInstance ? BodyInstance->GetPhysicsActorHandle() : nullptr;
+            if (Handle != Probe.AttachedHandle)
+            {
+                bProbesDirty = true;
+            }
+        }
+    }
+
+    if (bProbesDirty)
+    {
+        PushProbesToPhysics();
+    }
+}
+
+TStatId UCylinderProbeSubsystem::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(UCylinderProbeSubsystem, STATGROUP_Tickables);
+}
+
+FCylinderProbeHandle UCylinderProbeSubsystem::RegisterProbe(const FCylinderProbeDesc& Desc)
+{
+    FCylinderProbeHandle Handle;
+    if (!SimCallback)
+    {
+        return Handle;
+    }
+
+    Handle.Id = NextProbeId++;
+
+    FRegisteredProbe& Probe = Probes.Add(Handle.Id);
+    Probe.Results = MakeShared<FResultBuffer, ESPMode::ThreadSafe>();
+    UpdateProbe(Handle, Desc);
+    return Handle;
+}
+
+bool UCylinderProbeSubsystem::UpdateProbe(const FCylinderProbeHandle Handle, const FCylinderProbeDesc& Desc)
+{
+    FRegisteredProbe* Probe = Probes.Find(Handle.Id);
+    if (!Probe)
+    {
+        return false;
+    }
+
+    Probe->Desc = Desc;
+    Probe->Shape = FCylinderPrismShapeCache::FindOrCreate(Desc.NumSides);
+    bProbesDirty = true;
+    return true;
+}
+
+void UCylinderProbeSubsystem::UnregisterProbe(FCylinderProbeHandle& Handle)
+{
+    if (Probes.Remove(Handle.Id) > 0)
+    {
+        bProbesDirty = true;
+
+        // 追従先を破棄する直前に呼ばれることが多いので、Tick を待たずに送る
+        PushProbesToPhysics();
+    }
+    Handle.Id = INDEX_NONE;
+}
+
+bool UCylinderProbeSubsystem::ReadProbe(const FCylinderProbeHandle Handle, FCylinderProbeResult& OutResult)
+{
+    const FRegisteredProbe* Probe = Probes.Find(Handle.Id);
+    if (!Probe)
+    {
+        return false;
+    }
+
+    FResultBuffer& Results = *Probe->Results;
+    if (Results.IsDirty())
+    {
+        Results.SwapReadBuffers();
+    }
+    OutResult = Results.Read();
+    return true;
+}
+
+void UCylinderProbeSubsystem::PushProbesToPhysics()
+{
+    bProbesDirty = false;
+
+    if (!SimCallback)
+    {
+        return;
+    }
+
+    FCylinderProbeSimInput* Input = SimCallback->GetProducerInputData_External();
+    Input->Probes.Reset(Probes.Num());
+    Input->bHasProbes = true;
+
+    for (auto& Pair : Probes)
+    {
+        FRegisteredProbe& Probe = Pair.Value;
+
+        Chaos::FSingleParticlePhysicsProxy* AttachedProxy = nullptr;
+        if (const UPrimitiveComponent* AttachTo = Probe.Desc.AttachTo.Get())
+        {
+            if (const FBodyInstance* BodyInstance = AttachTo->GetBodyInstance())
+            {
+                AttachedProxy = BodyInstance->GetPhysicsActorHandle();
+            }
+        }
+        Probe.AttachedHandle = AttachedProxy;
+
+        // 追従先が指定されているのにボディが無い間は評価しない
+        if (!Probe.Desc.AttachTo.IsExplicitlyNull() && !AttachedProxy)
+        {
+            continue;
+        }
+
+        if (!Probe.Shape || !Probe.Shape->IsCooked())
+        {
+            continue;
+        }
+
+        FCylinderProbeState& State = Input->Probes.AddDefaulted_GetRef();
+        State.Id = Pair.Key;
+        State.LocalTransform = Probe.Desc.LocalTransform;
+        State.TraceDistance = FMath::Max(Probe.Desc.TraceDistance, 0.0f);
+        State.Radius = Probe.Desc.Radius;
+        State.HalfLength = Probe.Desc.HalfLength;
+        State.Channel = Probe.Desc.Channel;
+        State.Convex = Probe.Shape->GetBodySetup()->AggGeom.ConvexElems[0].GetChaosConvexMesh();
+        State.AttachedProxy = AttachedProxy;
+        State.Results = Probe.Results;
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Containers/TripleBuffer.h"
+#include "Engine/EngineTypes.h"
+#include "CylinderPrismShapeCache.h"
+#include "CylinderProbeSubsystem.generated.h"
+
+class UPrimitiveComponent;
+class FCylinderProbeSimCallback;
+
+/** 物理スレッドで評価したプローブ1回分の結果 */
+USTRUCT(BlueprintType)
+struct FCylinderProbeResult
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category="CylinderProbe")
+    bool bHit = false;
+
+    /** 始点からヒット位置までの距離（cm）。ヒットしなければ TraceDistance */
+    UPROPERTY(BlueprintReadOnly, Category="CylinderProbe")
+    float Distance = 0.0f;
+
+    UPROPERTY(BlueprintReadOnly, Category="CylinderProbe")
+    FVector ImpactPoint = FVector::ZeroVector;
+
+    UPROPERTY(BlueprintReadOnly, Category="CylinderProbe")
+    FVector ImpactNormal = FVector::ZeroVector;
+
+    /** 評価時のプローブのワールド姿勢（親ボディのサブステップ姿勢を反映済み） */
+    UPROPERTY(BlueprintReadOnly, Category="CylinderProbe")
+    FTransform ProbeTransform;
+
+    /** 評価したサブステップのソルバ時刻（秒） */
+    UPROPERTY(BlueprintReadOnly, Category="CylinderProbe")
+    float SimTime = 0.0f;
+
+    /** プローブ登録後に評価した回数（0 = まだ一度も評価されていない） */
+    UPROPERTY(BlueprintReadOnly, Category="CylinderProbe")
+    int32 Sequence = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FCylinderProbeHandle
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    int32 Id = INDEX_NONE;
+
+    bool IsValid() const { return Id != INDEX_NONE; }
+};
+
+/** プローブの設定。姿勢は AttachTo のボディ基準（無ければワールド）。 */
+USTRUCT(BlueprintType)
+struct FCylinderProbeDesc
+{
+    GENERATED_BODY()
+
+    /** 円柱の始点中心・向き（ローカルZ-方向へトレース。UCylinderConvexTraceComponent と同じ） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderProbe")
+    FTransform LocalTransform;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderProbe")
+    float TraceDistance = 1000.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderProbe")
+    float Radius = 30.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderProbe")
+    float HalfLength = 50.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderProbe", meta=(ClampMin="3", ClampMax="128"))
+    int32 NumSides = 16;
+
+    /** この Trace チャンネルを Block するシェイプにだけヒット */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderProbe")
+    TEnumAsByte<ECollisionChannel> Channel = ECC_Visibility;
+
+    /** サブステップごとの姿勢に追従させるボディ（自分自身はヒット対象から除外） */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="CylinderProbe")
+    TWeakObjectPtr<UPrimitiveComponent> AttachTo;
+};
+
+/**
+ * 物理ソルバのサブステップごとに評価される常駐の円柱プローブ。
+ *
+ * - 評価はソルバのシミュレーションコールバック内（物理スレッド）で、物理スレッド側の加速構造に対して行う
+ * - 結果はプローブごとのトリプルバッファに書かれ、ゲームスレッドはロック無しで最新の結果を読む
+ * - 物理スレッドではActorを参照できないため、タグ・Actor単位のフィルタは無し（チャンネルのみ）
+ * - 形状は UCylinderConvexTraceComponent の Prism モードと同じ多角柱
+ * - AttachTo のボディが破棄されると、物理スレッドは登録解除の通知で追従先を外し、次の Tick で送り直すまで評価しない
+ */
+UCLASS()
+class UCylinderProbeSubsystem : public UTickableWorldSubsystem
+{
+    GENERATED_BODY()
+
+public:
+    // UWorldSubsystem
+    virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+    virtual void Deinitialize() override;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual TStatId GetStatId() const override;
+
+    UFUNCTION(BlueprintCallable, Category="CylinderProbe")
+    FCylinderProbeHandle RegisterProbe(const FCylinderProbeDesc& Desc);
+
+    /** 設定を差し替える（結果バッファと Sequence は引き継ぐ） */
+    UFUNCTION(BlueprintCallable, Category="CylinderProbe")
+    bool UpdateProbe(FCylinderProbeHandle Handle, const FCylinderProbeDesc& Desc);
+
+    UFUNCTION(BlueprintCallable, Category="CylinderProbe")
+    void UnregisterProbe(UPARAM(ref) FCylinderProbeHandle& Handle);
+
+    /** 最新の結果を読む。物理スレッドが一度も評価していなければ Sequence == 0 */
+    UFUNCTION(BlueprintCallable, Category="CylinderProbe")
+    bool ReadProbe(FCylinderProbeHandle Handle, FCylinderProbeResult& OutResult);
+
+    using FResultBuffer = TTripleBuffer<FCylinderProbeResult>;
+
+private:
+    struct FRegisteredProbe
+    {
+        FCylinderProbeDesc Desc;
+        TSharedPtr<FCylinderPrismShape> Shape;
+        TSharedPtr<FResultBuffer, ESPMode::ThreadSafe> Results;
+
+        /** 物理スレッドへ送った時点の AttachTo の物理ハンドル（差し替わりの検出用） */
+        const void* AttachedHandle = nullptr;
+    };
+
+    /** 登録内容を物理スレッドへ送る（次のフレームのサブステップから反映） */
+    void PushProbesToPhysics();
+
+    TMap<int32, FRegisteredProbe> Probes;
+    int32 NextProbeId = 0;
+    bool bProbesDirty = false;
+
+    FCylinderProbeSimCallback* SimCallback = nullptr;
+};
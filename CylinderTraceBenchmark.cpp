@@ -0,0 +1,429 @@
+#include "CylinderConvexTraceComponent.h"
+
+#include "ActorTagIndexSubsystem.h"
+#include "Components/SphereComponent.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+
+/**
+ * 円柱トレースの性能・正しさ計測（コンソールコマンド）。
+ *
+ *   CylinderTrace.Benchmark [Density=200] [Traces=2000] [TagRatio=0.5] [Sides=8,16,32] [Radius=10,50] [Iters=8,32] [Seed=1]
+ *
+ * - 球コリジョンのActorを Density 個ランダム配置（TagRatio の割合にタグ付け）し、真上から -Z 方向にトレース
+ * - 期待値は軸方向に進む円柱と球の接触距離を解析的に求めたもの（Prism は角数ぶんの誤差を許容）
+ * - 設定の組み合わせごとに traces/sec・p50/p99 レイテンシ・不一致数をログ出力
+ * - -nullrhi のヘッドレス起動でも -ExecCmds で実行可能
+ * - 同じ計測を自動テスト（CylinderTrace.Benchmark.*）としても実行できる。不一致はテストの失敗になる
+ */
+namespace CylinderTraceBenchmark
+{
+    static const FName BenchTag(TEXT("CylinderTraceBench"));
+
+    static constexpr float FieldHalfSize = 2000.0f;
+    static constexpr float FieldTop = 1000.0f;
+    static constexpr float MinSphereRadius = 10.0f;
+    static constexpr float MaxSphereRadius = 80.0f;
+
+    struct FSphereInfo
+    {
+        FVector Center;
+        float Radius = 0.0f;
+        bool bTagged = false;
+        AActor* Actor = nullptr;
+    };
+
+    struct FConfig
+    {
+        ECylinderTraceShapeMode ShapeMode = ECylinderTraceShapeMode::Prism;
+        int32 NumSides = 16;
+        int32 MaxFilterIterations = 32;
+        float Radius = 10.0f;
+    };
+
+    /** 1つの設定の計測結果 */
+    struct FStats
+    {
+        int32 NumHits = 0;
+        int32 NumMismatches = 0;
+        int32 NumSkipped = 0;
+        double TracesPerSecond = 0.0;
+        double P50 = 0.0;
+        double P99 = 0.0;
+    };
+
+    /** シーンと、試す設定の組み合わせ */
+    struct FSettings
+    {
+        int32 Density = 200;
+        int32 NumTraces = 2000;
+        float TagRatio = 0.5f;
+        int32 Seed = 1;
+        TArray<int32> SidesList = { 8, 16, 32 };
+        TArray<float> RadiusList = { 10.0f, 50.0f };
+        TArray<int32> ItersList = { 8, 32 };
+    };
+
+    static TArray<int32> ParseIntList(const FString& Value)
+    {
+        TArray<FString> Parts;
+        Value.ParseIntoArray(Parts, TEXT(","));
+
+        TArray<int32> Result;
+        for (const FString& Part : Parts)
+        {
+            Result.Add(FCString::Atoi(*Part));
+        }
+        return Result;
+    }
+
+    static TArray<float> ParseFloatList(const FString& Value)
+    {
+        TArray<FString> Parts;
+        Value.ParseIntoArray(Parts, TEXT(","));
+
+        TArray<float> Result;
+        for (const FString& Part : Parts)
+        {
+            Result.Add(FCString::Atof(*Part));
+        }
+        return Result;
+    }
+
+    /**
+     * 軸方向（-Z）に進む円柱（半径 R・半長 H、中心の開始高さ StartZ）が球に最初に触れる移動距離。
+     * 底面の円板・縁の円周のどちらで触れるかで場合分け。触れなければ false。
+     */
+    static bool ComputeAnalyticDistance(const FVector& Start, const float R, const float H, const FSphereInfo& Sphere, float& OutDistance)
+    {
+        const float Lateral = FVector2D(Sphere.Center.X - Start.X, Sphere.Center.Y - Start.Y).Size();
+        if (Lateral > R + Sphere.Radius)
+        {
+            return false;
+        }
+
+        // 底面内なら球の頂点、縁の外側なら縁の円周との接点の高さ
+        const float Rise = (Lateral <= R)
+            ? Sphere.Radius
+            : FMath::Sqrt(FMath::Max(Sphere.Radius * Sphere.Radius - FMath::Square(Lateral - R), 0.0f));
+
+        OutDistance = (Start.Z - H) - (Sphere.Center.Z + Rise);
+        return OutDistance >= 0.0f;
+    }
+
+    /** Prism の近似誤差で結果が変わり得る（縁付近の）ケースか */
+    static bool IsAmbiguous(const FVector& Start, const FConfig& Config, const FSphereInfo& Sphere)
+    {
+        if (Config.ShapeMode == ECylinderTraceShapeMode::ExactCylinder)
+        {
+            return false;
+        }
+
+        const float Lateral = FVector2D(Sphere.Center.X - Start.X, Sphere.Center.Y - Start.Y).Size();
+        const float InnerR = Config.Radius * FMath::Cos(PI / FMath::Max(Config.NumSides, 3));
+        return Lateral >= InnerR && Lateral <= Config.Radius + Sphere.Radius;
+    }
+
+    static void SpawnScene(UWorld* World, const int32 Density, const float TagRatio, FRandomStream& Random, TArray<FSphereInfo>& OutSpheres)
+    {
+        for (int32 i = 0; i < Density; ++i)
+        {
+            FSphereInfo& Info = OutSpheres.AddDefaulted_GetRef();
+            Info.Radius = Random.FRandRange(MinSphereRadius, MaxSphereRadius);
+            Info.Center = FVector(
+                Random.FRandRange(-FieldHalfSize, FieldHalfSize),
+                Random.FRandRange(-FieldHalfSize, FieldHalfSize),
+                Random.FRandRange(0.0f, FieldTop * 0.5f));
+            Info.bTagged = Random.FRand() < TagRatio;
+
+            FActorSpawnParameters Params;
+            Params.ObjectFlags |= RF_Transient;
+            AActor* Actor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Info.Center), Params);
+
+            USphereComponent* Sphere = NewObject<USphereComponent>(Actor);
+            Sphere->InitSphereRadius(Info.Radius);
+            Sphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+            Sphere->SetCollisionObjectType(ECC_WorldStatic);
+            Sphere->SetCollisionResponseToAllChannels(ECR_Block);
+            Actor->SetRootComponent(Sphere);
+            Sphere->RegisterComponent();
+            Actor->SetActorLocation(Info.Center);
+
+            if (Info.bTagged)
+            {
+                // スポーン後のタグ変更なので索引にも反映
+                if (UActorTagIndexSubsystem* TagIndex = World->GetSubsystem<UActorTagIndexSubsystem>())
+                {
+                    TagIndex->AddActorTag(Actor, BenchTag);
+                }
+                else
+                {
+                    Actor->Tags.Add(BenchTag);
+                }
+            }
+
+            Info.Actor = Actor;
+        }
+    }
+
+    static FStats RunConfig(
+        UCylinderConvexTraceComponent* Tracer,
+        const FConfig& Config,
+        const TArray<FSphereInfo>& Spheres,
+        const int32 NumTraces,
+        const int32 Seed
+    )
+    {
+        Tracer->ShapeMode = Config.ShapeMode;
+        Tracer->MaxFilterIterations = Config.MaxFilterIterations;
+        Tracer->BuildUnitPrismConvex(Config.NumSides);
+
+        const float HalfLength = Config.Radius;
+        const float TraceDistance = FieldTop * 2.0f;
+
+        // 許容誤差: Exact は数値誤差のみ、Prism は多角形の内接誤差ぶん
+        const float Tolerance = (Config.ShapeMode == ECylinderTraceShapeMode::ExactCylinder)
+            ? 0.5f
+            : 0.5f + Config.Radius * (1.0f - FMath::Cos(PI / FMath::Max(Config.NumSides, 3))) * 4.0f;
+
+        FRandomStream Random(Seed);
+        TArray<double> Latencies;
+        Latencies.Reserve(NumTraces);
+
+        FStats Stats;
+
+        for (int32 i = 0; i < NumTraces; ++i)
+        {
+            const FVector Start(
+                Random.FRandRange(-FieldHalfSize, FieldHalfSize),
+                Random.FRandRange(-FieldHalfSize, FieldHalfSize),
+                FieldTop + HalfLength);
+            const EActorTagFilterMode FilterMode = (i & 1) ? EActorTagFilterMode::Exclude : EActorTagFilterMode::Include;
+
+            FHitResult Hit;
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            const bool bHit = Tracer->CylinderTraceFromTransform(FTransform(Start), TraceDistance, Config.Radius, HalfLength, BenchTag, FilterMode, Hit);
+            Latencies.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles));
+
+            Stats.NumHits += bHit ? 1 : 0;
+
+            // 期待値: タグ条件を満たす球のうち最も手前
+            bool bExpected = false;
+            bool bAmbiguous = false;
+            float ExpectedDistance = TNumericLimits<float>::Max();
+            for (const FSphereInfo& Sphere : Spheres)
+            {
+                const bool bAccepted = (FilterMode == EActorTagFilterMode::Include) ? Sphere.bTagged : !Sphere.bTagged;
+                if (!bAccepted)
+                {
+                    continue;
+                }
+
+                bAmbiguous |= IsAmbiguous(Start, Config, Sphere);
+
+                float Distance = 0.0f;
+                if (ComputeAnalyticDistance(Start, Config.Radius, HalfLength, Sphere, Distance) && Distance < ExpectedDistance)
+                {
+                    bExpected = true;
+                    ExpectedDistance = Distance;
+                }
+            }
+
+            if (bAmbiguous)
+            {
+                ++Stats.NumSkipped;
+                continue;
+            }
+
+            if (bHit != bExpected || (bHit && FMath::Abs(Hit.Distance - ExpectedDistance) > Tolerance))
+            {
+                ++Stats.NumMismatches;
+            }
+        }
+
+        Latencies.Sort();
+
+        double TotalMs = 0.0;
+        for (const double Latency : Latencies)
+        {
+            TotalMs += Latency;
+        }
+
+        Stats.P50 = Latencies.Num() > 0 ? Latencies[Latencies.Num() / 2] : 0.0;
+        Stats.P99 = Latencies.Num() > 0 ? Latencies[FMath::Min(Latencies.Num() - 1, Latencies.Num() * 99 / 100)] : 0.0;
+        Stats.TracesPerSecond = TotalMs > 0.0 ? NumTraces / (TotalMs * 0.001) : 0.0;
+        return Stats;
+    }
+
+    static FString DescribeConfig(const FConfig& Config)
+    {
+        return FString::Printf(TEXT("Mode=%s Sides=%d Iters=%d Radius=%.1f"),
+            Config.ShapeMode == ECylinderTraceShapeMode::ExactCylinder ? TEXT("Exact") : TEXT("Prism"),
+            Config.NumSides, Config.MaxFilterIterations, Config.Radius);
+    }
+
+    static FString DescribeStats(const FStats& Stats)
+    {
+        return FString::Printf(TEXT("%.0f traces/s p50=%.4fms p99=%.4fms | hits=%d mismatches=%d skipped=%d"),
+            Stats.TracesPerSecond, Stats.P50, Stats.P99,
+            Stats.NumHits, Stats.NumMismatches, Stats.NumSkipped);
+    }
+
+    static FSettings ParseSettings(const TArray<FString>& Args)
+    {
+        FSettings Settings;
+        for (const FString& Arg : Args)
+        {
+            FString Key;
+            FString Value;
+            if (!Arg.Split(TEXT("="), &Key, &Value))
+            {
+                continue;
+            }
+
+            if (Key == TEXT("Density")) { Settings.Density = FMath::Max(FCString::Atoi(*Value), 0); }
+            else if (Key == TEXT("Traces")) { Settings.NumTraces = FMath::Max(FCString::Atoi(*Value), 1); }
+            else if (Key == TEXT("TagRatio")) { Settings.TagRatio = FMath::Clamp(FCString::Atof(*Value), 0.0f, 1.0f); }
+            else if (Key == TEXT("Seed")) { Settings.Seed = FCString::Atoi(*Value); }
+            else if (Key == TEXT("Sides")) { Settings.SidesList = ParseIntList(Value); }
+            else if (Key == TEXT("Radius")) { Settings.RadiusList = ParseFloatList(Value); }
+            else if (Key == TEXT("Iters")) { Settings.ItersList = ParseIntList(Value); }
+        }
+        return Settings;
+    }
+
+    /** シーンを配置し、全ての設定の組み合わせを計測して片付ける */
+    static void RunScene(UWorld* World, const FSettings& Settings, TArray<TPair<FConfig, FStats>>& OutResults)
+    {
+        FRandomStream Random(Settings.Seed);
+        TArray<FSphereInfo> Spheres;
+        SpawnScene(World, Settings.Density, Settings.TagRatio, Random, Spheres);
+
+        FActorSpawnParameters Params;
+        Params.ObjectFlags |= RF_Transient;
+        AActor* TracerActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, Params);
+        UCylinderConvexTraceComponent* Tracer = NewObject<UCylinderConvexTraceComponent>(TracerActor);
+        TracerActor->SetRootComponent(Tracer);
+        Tracer->RegisterComponent();
+
+        for (const float Radius : Settings.RadiusList)
+        {
+            for (const int32 Iters : Settings.ItersList)
+            {
+                for (const int32 Sides : Settings.SidesList)
+                {
+                    FConfig Config;
+                    Config.NumSides = Sides;
+                    Config.MaxFilterIterations = Iters;
+                    Config.Radius = Radius;
+                    OutResults.Emplace(Config, RunConfig(Tracer, Config, Spheres, Settings.NumTraces, Settings.Seed + 1));
+                }
+
+                FConfig Exact;
+                Exact.ShapeMode = ECylinderTraceShapeMode::ExactCylinder;
+                Exact.MaxFilterIterations = Iters;
+                Exact.Radius = Radius;
+                OutResults.Emplace(Exact, RunConfig(Tracer, Exact, Spheres, Settings.NumTraces, Settings.Seed + 1));
+            }
+        }
+
+        TracerActor->Destroy();
+        for (const FSphereInfo& Sphere : Spheres)
+        {
+            Sphere.Actor->Destroy();
+        }
+    }
+
+    static void Run(const TArray<FString>& Args, UWorld* World)
+    {
+        if (!World || !World->IsGameWorld())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("CylinderTrace.Benchmark: Run in a game world (PIE or -game)."));
+            return;
+        }
+
+        const FSettings Settings = ParseSettings(Args);
+        UE_LOG(LogTemp, Log, TEXT("CylinderTrace.Benchmark: Density=%d Traces=%d TagRatio=%.2f Seed=%d"),
+            Settings.Density, Settings.NumTraces, Settings.TagRatio, Settings.Seed);
+
+        TArray<TPair<FConfig, FStats>> Results;
+        RunScene(World, Settings, Results);
+
+        for (const TPair<FConfig, FStats>& Result : Results)
+        {
+            UE_LOG(LogTemp, Log, TEXT("CylinderTrace.Benchmark: %s | %s"), *DescribeConfig(Result.Key), *DescribeStats(Result.Value));
+        }
+    }
+
+    static FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+        TEXT("CylinderTrace.Benchmark"),
+        TEXT("Measures UCylinderConvexTraceComponent throughput/latency and checks hits against analytic cylinders. ")
+        TEXT("Args: Density=N Traces=N TagRatio=F Seed=N Sides=a,b Radius=a,b Iters=a,b"),
+        FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&Run)
+    );
+}
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+    FCylinderTraceBenchmarkTest,
+    "CylinderTrace.Benchmark",
+    EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+void FCylinderTraceBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+    // コンソールコマンドと同じ引数。テスト時間を抑えるためトレース数は少なめ
+    OutBeautifiedNames.Add(TEXT("Sparse"));
+    OutTestCommands.Add(TEXT("Density=50 Traces=500 TagRatio=0.5"));
+
+    OutBeautifiedNames.Add(TEXT("Dense"));
+    OutTestCommands.Add(TEXT("Density=400 Traces=500 TagRatio=0.5"));
+
+    OutBeautifiedNames.Add(TEXT("MostlyTagged"));
+    OutTestCommands.Add(TEXT("Density=200 Traces=500 TagRatio=0.9"));
+
+    OutBeautifiedNames.Add(TEXT("RarelyTagged"));
+    OutTestCommands.Add(TEXT("Density=200 Traces=500 TagRatio=0.1"));
+}
+
+bool FCylinderTraceBenchmarkTest::RunTest(const FString& Parameters)
+{
+    using namespace CylinderTraceBenchmark;
+
+    TArray<FString> Args;
+    Parameters.ParseIntoArrayWS(Args);
+    const FSettings Settings = ParseSettings(Args);
+
+    // 計測専用の空のゲームワールド（タグ索引を使うので BeginPlay まで進める）
+    UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CylinderTraceBenchmark"));
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    WorldContext.SetCurrentWorld(World);
+    World->InitializeActorsForPlay(FURL());
+    World->BeginPlay();
+
+    TArray<TPair<FConfig, FStats>> Results;
+    RunScene(World, Settings, Results);
+
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+
+    for (const TPair<FConfig, FStats>& Result : Results)
+    {
+        const FString Line = FString::Printf(TEXT("%s | %s"), *DescribeConfig(Result.Key), *DescribeStats(Result.Value));
+        if (Result.Value.NumMismatches > 0)
+        {
+            AddError(Line);
+        }
+        else
+        {
+            AddInfo(Line);
+        }
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,214 @@
+#include "SceneQueryRecorder.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryWriter.h"
+
+std::atomic<bool> FSceneQueryRecorder::bRecording(false);
+
+namespace
+{
+    /** 書き出し前に溜めるバイト数 */
+    constexpr int32 FlushThresholdBytes = 1024 * 1024;
+
+    FCriticalSection RecorderLock;
+    TUniquePtr<FArchive> FileWriter;
+    TArray<uint8> PendingBytes;
+    double StartTimeSeconds = 0.0;
+    FDelegateHandle PreExitHandle;
+
+    void SerializeTransform(FArchive& Ar, FTransform& Transform)
+    {
+        FVector3f Location(Transform.GetLocation());
+        FQuat4f Rotation(Transform.GetRotation());
+        FVector3f Scale(Transform.GetScale3D());
+        Ar << Location << Rotation << Scale;
+
+        if (Ar.IsLoading())
+        {
+            Transform = FTransform(FQuat(Rotation), FVector(Location), FVector(Scale));
+        }
+    }
+
+    void SerializeVector(FArchive& Ar, FVector& Vector)
+    {
+        FVector3f Value(Vector);
+        Ar << Value;
+        if (Ar.IsLoading())
+        {
+            Vector = FVector(Value);
+        }
+    }
+
+    void SerializeQuat(FArchive& Ar, FQuat& Quat)
+    {
+        FQuat4f Value(Quat);
+        Ar << Value;
+        if (Ar.IsLoading())
+        {
+            Quat = FQuat(Value);
+        }
+    }
+}
+
+FArchive& operator<<(FArchive& Ar, FCylinderTraceRecord& Record)
+{
+    SerializeTransform(Ar, Record.Transform);
+    Ar << Record.TraceDistance << Record.Radius << Record.HalfLength;
+    Ar << Record.Tag << Record.FilterMode;
+
+    Ar << Record.NumSides << Record.MaxFilterIterations << Record.ShapeMode;
+    Ar << Record.bSinglePassTagFilter << Record.MaxDeviationCm << Record.CollisionObjectType;
+    Ar << Record.ChannelResponses;
+
+    Ar << Record.bHit << Record.HitDistance;
+    SerializeVector(Ar, Record.ImpactPoint);
+    return Ar;
+}
+
+FArchive& operator<<(FArchive& Ar, FFocusSlabRecord& Record)
+{
+    SerializeVector(Ar, Record.CamPos);
+    SerializeQuat(Ar, Record.CamRot);
+    SerializeVector(Ar, Record.TargetCenter);
+    Ar << Record.SlabSizeCm << Record.SlabThicknessCm;
+
+    Ar << Record.bHit << Record.FocusDistanceCm;
+    return Ar;
+}
+
+namespace SceneQueryRecordFile
+{
+    FArchive& operator<<(FArchive& Ar, FRecordHeader& Header)
+    {
+        uint8 Kind = static_cast<uint8>(Header.Kind);
+        Ar << Kind << Header.TimeSeconds << Header.DurationMs;
+        Header.Kind = static_cast<ESceneQueryRecordKind>(Kind);
+        return Ar;
+    }
+}
+
+bool FSceneQueryRecorder::Start(const FString& Path)
+{
+    FScopeLock Lock(&RecorderLock);
+
+    if (FileWriter)
+    {
+        return false;
+    }
+
+    FileWriter.Reset(IFileManager::Get().CreateFileWriter(*Path));
+    if (!FileWriter)
+    {
+        return false;
+    }
+
+    uint32 Magic = SceneQueryRecordFile::Magic;
+    uint32 Version = SceneQueryRecordFile::Version;
+    *FileWriter << Magic << Version;
+
+    PendingBytes.Reset();
+    StartTimeSeconds = FPlatformTime::Seconds();
+    bRecording.store(true);
+
+    // 記録中のまま終了しても溜めた分を失わないよう、終了前に閉じる
+    if (!PreExitHandle.IsValid())
+    {
+        PreExitHandle = FCoreDelegates::OnPreExit.AddStatic(&FSceneQueryRecorder::Stop);
+    }
+    return true;
+}
+
+void FSceneQueryRecorder::Stop()
+{
+    FScopeLock Lock(&RecorderLock);
+
+    bRecording.store(false);
+
+    if (FileWriter)
+    {
+        FlushLocked();
+        FileWriter->Close();
+        FileWriter.Reset();
+    }
+}
+
+void FSceneQueryRecorder::RecordCylinderTrace(FCylinderTraceRecord& Record, const double DurationSeconds)
+{
+    Append(ESceneQueryRecordKind::CylinderTrace, Record, DurationSeconds);
+}
+
+void FSceneQueryRecorder::RecordFocusSlab(FFocusSlabRecord& Record, const double DurationSeconds)
+{
+    Append(ESceneQueryRecordKind::FocusSlab, Record, DurationSeconds);
+}
+
+template<typename TRecord>
+void FSceneQueryRecorder::Append(const ESceneQueryRecordKind Kind, TRecord& Record, const double DurationSeconds)
+{
+    FScopeLock Lock(&RecorderLock);
+
+    if (!FileWriter)
+    {
+        return;
+    }
+
+    SceneQueryRecordFile::FRecordHeader Header;
+    Header.Kind = Kind;
+    Header.TimeSeconds = FPlatformTime::Seconds() - StartTimeSeconds;
+    Header.DurationMs = static_cast<float>(DurationSeconds * 1000.0);
+
+    FMemoryWriter Writer(PendingBytes, false, true); // 末尾から追記
+    Writer << Header;
+    Writer << Record;
+
+    if (PendingBytes.Num() >= FlushThresholdBytes)
+    {
+        FlushLocked();
+    }
+}
+
+void FSceneQueryRecorder::FlushLocked()
+{
+    if (FileWriter && PendingBytes.Num() > 0)
+    {
+        FileWriter->Serialize(PendingBytes.GetData(), PendingBytes.Num());
+    }
+    PendingBytes.Reset();
+}
+
+namespace
+{
+    FAutoConsoleCommand StartCommand(
+        TEXT("SceneQueryRecorder.Start"),
+        TEXT("Starts recording cylinder/focus slab scene queries. Args: [Path] (default Saved/SceneQueries/<date>.sqrec)"),
+        FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+        {
+            const FString Path = Args.Num() > 0
+                ? Args[0]
+                : FPaths::ProjectSavedDir() / TEXT("SceneQueries") / (FDateTime::Now().ToString() + TEXT(".sqrec"));
+
+            if (FSceneQueryRecorder::Start(Path))
+            {
+                UE_LOG(LogTemp, Log, TEXT("SceneQueryRecorder: Recording to %s"), *Path);
+            }
+            else
+            {
+                UE_LOG(LogTemp, Warning, TEXT("SceneQueryRecorder: Could not start recording to %s (already recording?)"), *Path);
+            }
+        })
+    );
+
+    FAutoConsoleCommand StopCommand(
+        TEXT("SceneQueryRecorder.Stop"),
+        TEXT("Stops recording scene queries."),
+        FConsoleCommandDelegate::CreateLambda([]()
+        {
+            FSceneQueryRecorder::Stop();
+            UE_LOG(LogTemp, Log, TEXT("SceneQueryRecorder: Stopped"));
+        })
+    );
+}
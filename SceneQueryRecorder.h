@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <atomic>
+
+/** 記録するクエリの種類 */
+enum class ESceneQueryRecordKind : uint8
+{
+    CylinderTrace = 0,
+    FocusSlab = 1,
+};
+
+/** UCylinderConvexTraceComponent::CylinderTraceFromTransform 1回分（入力・コンポーネント設定・結果） */
+struct FCylinderTraceRecord
+{
+    // 入力
+    FTransform Transform;
+    float TraceDistance = 0.0f;
+    float Radius = 0.0f;
+    float HalfLength = 0.0f;
+    FString Tag;
+    uint8 FilterMode = 0;
+
+    // 結果に影響するコンポーネント設定
+    int32 NumSides = 0;
+    int32 MaxFilterIterations = 0;
+    uint8 ShapeMode = 0;
+    bool bSinglePassTagFilter = false;
+    float MaxDeviationCm = 0.0f;
+    uint8 CollisionObjectType = 0;
+
+    /** チャンネルごとの応答（ECollisionResponse、ECollisionChannel の順） */
+    TArray<uint8> ChannelResponses;
+
+    // 結果
+    bool bHit = false;
+    float HitDistance = 0.0f;
+    FVector ImpactPoint = FVector::ZeroVector;
+
+    friend FArchive& operator<<(FArchive& Ar, FCylinderTraceRecord& Record);
+};
+
+/** SweepFocusSlabAndGetForwardDistance 1回分 */
+struct FFocusSlabRecord
+{
+    // 入力
+    FVector CamPos = FVector::ZeroVector;
+    FQuat CamRot = FQuat::Identity;
+    FVector TargetCenter = FVector::ZeroVector;
+    float SlabSizeCm = 0.0f;
+    float SlabThicknessCm = 0.0f;
+
+    // 結果
+    bool bHit = false;
+    float FocusDistanceCm = 0.0f;
+
+    friend FArchive& operator<<(FArchive& Ar, FFocusSlabRecord& Record);
+};
+
+/**
+ * シーンクエリの記録ファイル（リトルエンディアンのバイナリ）。
+ *
+ *   Header : Magic 'SQRC' / Version
+ *   Record : Kind(uint8) / 記録開始からの時刻(double 秒) / 実行時間(float ミリ秒) / 種類ごとの本体
+ *
+ * 位置・回転は float で保存します（再生用途には十分な精度）。
+ */
+namespace SceneQueryRecordFile
+{
+    constexpr uint32 Magic = 0x43525153; // "SQRC"
+    constexpr uint32 Version = 2;
+
+    struct FRecordHeader
+    {
+        ESceneQueryRecordKind Kind = ESceneQueryRecordKind::CylinderTrace;
+        double TimeSeconds = 0.0;
+        float DurationMs = 0.0f;
+
+        friend FArchive& operator<<(FArchive& Ar, FRecordHeader& Header);
+    };
+}
+
+/**
+ * 実ゲーム中のシーンクエリ（入力・フィルタ・結果・所要時間）をファイルに記録します（オプトイン）。
+ *
+ *   SceneQueryRecorder.Start [Path]   記録開始（省略時 Saved/SceneQueries/<日時>.sqrec）
+ *   SceneQueryRecorder.Stop           記録終了
+ *
+ * 記録していない間のコストは IsRecording() の1回の読み取りのみ。
+ * 非同期で投げたクエリ（UCameraAutofocusComponent のスイープ）は所要時間を測れないので 0 で記録します。
+ * 記録中にエンジンが終了した場合も、終了前（FCoreDelegates::OnPreExit）に書き出して閉じます。
+ * 再生は USceneQueryReplayCommandlet（-run=SceneQueryReplay）で行います。
+ */
+class FSceneQueryRecorder
+{
+public:
+    static bool IsRecording() { return bRecording.load(std::memory_order_relaxed); }
+
+    static bool Start(const FString& Path);
+    static void Stop();
+
+    static void RecordCylinderTrace(FCylinderTraceRecord& Record, double DurationSeconds);
+    static void RecordFocusSlab(FFocusSlabRecord& Record, double DurationSeconds);
+
+private:
+    /** Header を書いてから Body を追記（必要ならファイルへ書き出し） */
+    template<typename TRecord>
+    static void Append(ESceneQueryRecordKind Kind, TRecord& Record, double DurationSeconds);
+
+    static void FlushLocked();
+
+    static std::atomic<bool> bRecording;
+};
@@ -0,0 +1,226 @@
+#include "SceneQueryReplayCommandlet.h"
+
+#include "CylinderConvexTraceComponent.h"
+#include "SceneQueryRecorder.h"
+#include "test.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+
+namespace
+{
+    /** 1種類分の計測結果 */
+    struct FReplayStats
+    {
+        TArray<double> ReplayMs;
+        double RecordedMsTotal = 0.0;
+        int32 NumMismatches = 0;
+
+        void Report(const TCHAR* Name)
+        {
+            if (ReplayMs.Num() == 0)
+            {
+                return;
+            }
+
+            ReplayMs.Sort();
+
+            double Total = 0.0;
+            for (const double Ms : ReplayMs)
+            {
+                Total += Ms;
+            }
+
+            const int32 Num = ReplayMs.Num();
+            auto Percentile = [this, Num](const int32 P)
+            {
+                return ReplayMs[FMath::Clamp(Num * P / 100, 0, Num - 1)];
+            };
+
+            UE_LOG(LogTemp, Display, TEXT("%s: count=%d mean=%.4fms p50=%.4fms p90=%.4fms p99=%.4fms max=%.4fms (recorded mean=%.4fms) mismatches=%d"),
+                Name, Num, Total / Num, Percentile(50), Percentile(90), Percentile(99), ReplayMs.Last(),
+                RecordedMsTotal / Num, NumMismatches);
+        }
+    };
+
+    UWorld* LoadWorldForQueries(const FString& MapName)
+    {
+        UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+        UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+        if (!World)
+        {
+            return nullptr;
+        }
+
+        World->AddToRoot();
+        World->WorldType = EWorldType::Game;
+
+        if (!World->bIsWorldInitialized)
+        {
+            // 描画・音は不要、シーンクエリ用の物理シーンだけ作る
+            World->InitWorld(UWorld::InitializationValues()
+                .InitializeScenes(false)
+                .AllowAudioPlayback(false)
+                .RequiresHitProxies(false)
+                .CreatePhysicsScene(true)
+                .CreateNavigation(false)
+                .CreateAISystem(false)
+                .ShouldSimulatePhysics(false)
+                .EnableTraceCollision(true));
+        }
+
+        World->UpdateWorldComponents(true, false);
+        return World;
+    }
+
+    void ApplyRecordedSettings(UCylinderConvexTraceComponent* Tracer, const FCylinderTraceRecord& Record)
+    {
+        Tracer->MaxFilterIterations = Record.MaxFilterIterations;
+        Tracer->ShapeMode = static_cast<ECylinderTraceShapeMode>(Record.ShapeMode);
+        Tracer->bSinglePassTagFilter = Record.bSinglePassTagFilter;
+        Tracer->MaxDeviationCm = Record.MaxDeviationCm;
+
+        const ECollisionChannel Channel = static_cast<ECollisionChannel>(Record.CollisionObjectType);
+        if (Tracer->GetCollisionObjectType() != Channel)
+        {
+            Tracer->SetCollisionObjectType(Channel);
+        }
+
+        // 応答が違うとブロック判定が変わり、記録と食い違う
+        FCollisionResponseContainer Responses;
+        for (int32 Index = 0; Index < Record.ChannelResponses.Num() && Index < ECC_MAX; ++Index)
+        {
+            Responses.SetResponse(static_cast<ECollisionChannel>(Index), static_cast<ECollisionResponse>(Record.ChannelResponses[Index]));
+        }
+        if (Tracer->GetCollisionResponseToChannels() != Responses)
+        {
+            Tracer->SetCollisionResponseToChannels(Responses);
+        }
+
+        Tracer->NumSides = Record.NumSides;
+        Tracer->BuildUnitPrismConvex(Record.NumSides);
+    }
+}
+
+USceneQueryReplayCommandlet::USceneQueryReplayCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+}
+
+int32 USceneQueryReplayCommandlet::Main(const FString& Params)
+{
+    FString FilePath;
+    FString MapName;
+    int32 Repeat = 1;
+    FParse::Value(*Params, TEXT("File="), FilePath);
+    FParse::Value(*Params, TEXT("Map="), MapName);
+    FParse::Value(*Params, TEXT("Repeat="), Repeat);
+    Repeat = FMath::Max(Repeat, 1);
+
+    if (FilePath.IsEmpty() || MapName.IsEmpty())
+    {
+        UE_LOG(LogTemp, Error, TEXT("SceneQueryReplay: Usage -File=<path.sqrec> -Map=<long package name> [-Repeat=N]"));
+        return 1;
+    }
+
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*FilePath));
+    if (!Reader)
+    {
+        UE_LOG(LogTemp, Error, TEXT("SceneQueryReplay: Could not open %s"), *FilePath);
+        return 1;
+    }
+
+    uint32 Magic = 0;
+    uint32 Version = 0;
+    *Reader << Magic << Version;
+    if (Magic != SceneQueryRecordFile::Magic || Version != SceneQueryRecordFile::Version)
+    {
+        UE_LOG(LogTemp, Error, TEXT("SceneQueryReplay: %s is not a scene query recording (version %u)"), *FilePath, Version);
+        return 1;
+    }
+
+    UWorld* World = LoadWorldForQueries(MapName);
+    if (!World)
+    {
+        UE_LOG(LogTemp, Error, TEXT("SceneQueryReplay: Could not load map %s"), *MapName);
+        return 1;
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.ObjectFlags |= RF_Transient;
+    AActor* TracerActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+    UCylinderConvexTraceComponent* Tracer = NewObject<UCylinderConvexTraceComponent>(TracerActor);
+    TracerActor->SetRootComponent(Tracer);
+    Tracer->RegisterComponent();
+
+    FReplayStats CylinderStats;
+    FReplayStats SlabStats;
+
+    while (!Reader->AtEnd() && !Reader->IsError())
+    {
+        SceneQueryRecordFile::FRecordHeader Header;
+        *Reader << Header;
+
+        if (Header.Kind == ESceneQueryRecordKind::CylinderTrace)
+        {
+            FCylinderTraceRecord Record;
+            *Reader << Record;
+
+            ApplyRecordedSettings(Tracer, Record);
+            const FName Tag = Record.Tag.IsEmpty() ? NAME_None : FName(*Record.Tag);
+
+            for (int32 i = 0; i < Repeat; ++i)
+            {
+                FHitResult Hit;
+                const double StartSeconds = FPlatformTime::Seconds();
+                const bool bHit = Tracer->CylinderTraceFromTransform(Record.Transform, Record.TraceDistance, Record.Radius, Record.HalfLength,
+                    Tag, static_cast<EActorTagFilterMode>(Record.FilterMode), Hit);
+                CylinderStats.ReplayMs.Add((FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+                CylinderStats.RecordedMsTotal += Header.DurationMs;
+
+                if (i == 0 && (bHit != Record.bHit || (bHit && !FMath::IsNearlyEqual(Hit.Distance, Record.HitDistance, 0.5f))))
+                {
+                    ++CylinderStats.NumMismatches;
+                }
+            }
+        }
+        else if (Header.Kind == ESceneQueryRecordKind::FocusSlab)
+        {
+            FFocusSlabRecord Record;
+            *Reader << Record;
+
+            for (int32 i = 0; i < Repeat; ++i)
+            {
+                float FocusDistance = 0.0f;
+                FHitResult Hit;
+                const double StartSeconds = FPlatformTime::Seconds();
+                const bool bHit = SweepFocusSlabAndGetForwardDistance(World, Record.CamPos, Record.CamRot, Record.TargetCenter,
+                    Record.SlabSizeCm, Record.SlabThicknessCm, FocusDistance, Hit);
+                SlabStats.ReplayMs.Add((FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+                SlabStats.RecordedMsTotal += Header.DurationMs;
+
+                if (i == 0 && (bHit != Record.bHit || (bHit && !FMath::IsNearlyEqual(FocusDistance, Record.FocusDistanceCm, 0.5f))))
+                {
+                    ++SlabStats.NumMismatches;
+                }
+            }
+        }
+        else
+        {
+            UE_LOG(LogTemp, Error, TEXT("SceneQueryReplay: Unknown record kind %d, stopping"), static_cast<int32>(Header.Kind));
+            break;
+        }
+    }
+
+    UE_LOG(LogTemp, Display, TEXT("SceneQueryReplay: %s on %s (x%d)"), *FilePath, *MapName, Repeat);
+    CylinderStats.Report(TEXT("CylinderTrace"));
+    SlabStats.Report(TEXT("FocusSlab"));
+
+    TracerActor->Destroy();
+    World->RemoveFromRoot();
+    return 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SceneQueryReplayCommandlet.generated.h"
+
+/**
+ * FSceneQueryRecorder の記録ファイルを、保存済みレベルに対してヘッドレスで再生し、
+ * クエリ種類ごとのコスト分布（平均・p50/p90/p99・最大）と記録時との結果の不一致数を出力します。
+ *
+ *   UnrealEditor-Cmd <Project> -run=SceneQueryReplay -File=<path.sqrec> -Map=/Game/Maps/MyMap [-Repeat=N]
+ *
+ * - 円柱トレースは記録時のコンポーネント設定（角数・形状モード等）を再現した一時コンポーネントで実行
+ * - 動的なActorは記録時の位置にはいないため、不一致は参考値（レベル配置物だけの場面で比較すること）
+ */
+UCLASS()
+class USceneQueryReplayCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    USceneQueryReplayCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -25,6 +25,51 @@
 #include "Sections/MovieSceneFloatSection.h"
 #include "Tracks/MovieSceneFloatTrack.h"
 
+#include "UObject/ObjectKey.h"
+
+namespace
+{
+	/** コンパイル済みヒエラルキーを使い回す（ルートシーケンスが変わった・編集された時だけコンパイルし直す） */
+	struct FCompiledHierarchyCache
+	{
+		TWeakObjectPtr<UMovieSceneSequence> RootSequence;
+		FGuid RootSignature;
+
+		/** コンパイルし直すたびに進める（Actor ごとの解決結果の無効化用） */
+		uint32 Generation = 0;
+	};
+
+	/** Actor ごとの解決結果。ValidRange（ルートのTick単位）の中にいる間はツリーを引き直さない */
+	struct FResolvedSequenceCache
+	{
+		TWeakPtr<ISequencer> Sequencer;
+		TWeakObjectPtr<UMovieSceneSequence> RootSequence;
+		uint32 Generation = 0;
+		TRange<FFrameNumber> ValidRange = TRange<FFrameNumber>::Empty();
+		TWeakObjectPtr<ULevelSequence> Result;
+	};
+
+	FCompiledHierarchyCache GCompiledHierarchyCache;
+	TMap<TObjectKey<AActor>, FResolvedSequenceCache> GResolvedSequenceCache;
+
+	void PruneResolvedSequenceCache()
+	{
+		// 消えた Actor の分だけ掃除（数が増えた時のみ）
+		if (GResolvedSequenceCache.Num() < 64)
+		{
+			return;
+		}
+
+		for (auto It = GResolvedSequenceCache.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
 #endif
 
 ULevelSequence* TargetActorEditorModule::FindActiveLevelSequenceForActor(const AActor* Actor)
@@ -78,6 +123,52 @@ ULevelSequence* TargetActorEditorModule::FindActiveLevelSequenceForActor(const A
 		return nullptr;
 	}
 
+	const FQualifiedFrameTime GlobalTime = Sequencer->GetGlobalTime();
+	const FFrameRate RootTickResolution = Sequencer->GetRootTickResolution();
+	const FFrameTime RootTime = FFrameRate::TransformTime(GlobalTime.Time, GlobalTime.Rate, RootTickResolution);
+
+	UMovieSceneCompiledDataManager* CompiledMgr =
+		UMovieSceneCompiledDataManager::GetPrecompiledData(EMovieSceneServerClientMask::All);
+	if (!CompiledMgr)
+	{
+		return nullptr;
+	}
+
+	const FMovieSceneCompiledDataID RootDataID = CompiledMgr->GetDataID(RootSequence);
+
+	// 変更後の ShotTrack を確実に反映させる（ルートが変わった・編集された時だけ。リグ評価ごとにはコンパイルしない）
+	const FGuid RootSignature = RootSequence->GetSignature();
+	if (GCompiledHierarchyCache.RootSequence.Get() != RootSequence
+		|| GCompiledHierarchyCache.RootSignature != RootSignature
+		|| CompiledMgr->IsDirty(RootDataID))
+	{
+		CompiledMgr->Compile(RootDataID, RootSequence, EMovieSceneServerClientMask::All);
+
+		GCompiledHierarchyCache.RootSequence = RootSequence;
+		GCompiledHierarchyCache.RootSignature = RootSignature;
+		++GCompiledHierarchyCache.Generation;
+	}
+
+	if (const FResolvedSequenceCache* Cached = GResolvedSequenceCache.Find(TObjectKey<AActor>(Actor)))
+	{
+		if (Cached->Sequencer.Pin() == Sequencer
+			&& Cached->RootSequence.Get() == RootSequence
+			&& Cached->Generation == GCompiledHierarchyCache.Generation
+			&& Cached->ValidRange.Contains(RootTime.FrameNumber))
+		{
+			return Cached->Result.Get();
+		}
+	}
+
+	PruneResolvedSequenceCache();
+
+	FResolvedSequenceCache& Resolved = GResolvedSequenceCache.FindOrAdd(TObjectKey<AActor>(Actor));
+	Resolved.Sequencer = Sequencer;
+	Resolved.RootSequence = RootSequence;
+	Resolved.Generation = GCompiledHierarchyCache.Generation;
+	Resolved.ValidRange = TRange<FFrameNumber>::Empty();
+	Resolved.Result = nullptr;
+
 	auto IsActorBoundInSequence = [Sequencer, Actor](FMovieSceneSequenceIDRef SequenceID) -> bool
 	{
 		AActor* MutableActor = const_cast<AActor*>(Actor);
@@ -93,37 +184,27 @@ ULevelSequence* TargetActorEditorModule::FindActiveLevelSequenceForActor(const A
 
 	if (IsActorBoundInSequence(MovieSceneSequenceID::Root))
 	{
+		// ルートのバインドは時刻に依らない
+		Resolved.ValidRange = TRange<FFrameNumber>::All();
+		Resolved.Result = RootLevelSequence;
 		return RootLevelSequence;
 	}
 
-	UMovieSceneCompiledDataManager* CompiledMgr =
-		UMovieSceneCompiledDataManager::GetPrecompiledData(EMovieSceneServerClientMask::All);
-	if (!CompiledMgr)
-	{
-		return nullptr;
-	}
-
-	const FMovieSceneCompiledDataID RootDataID = CompiledMgr->GetDataID(RootSequence);
-
-	// 変更後の ShotTrack を確実に反映させる
-	CompiledMgr->Compile(RootDataID, RootSequence, EMovieSceneServerClientMask::All);
-
 	const FMovieSceneSequenceHierarchy* Hierarchy = CompiledMgr->FindHierarchy(RootDataID);
 	if (!Hierarchy)
 	{
 		return nullptr;
 	}
 
-	const FQualifiedFrameTime GlobalTime = Sequencer->GetGlobalTime();
-	const FFrameRate RootTickResolution = Sequencer->GetRootTickResolution();
-	const FFrameTime RootTime = FFrameRate::TransformTime(GlobalTime.Time, GlobalTime.Rate, RootTickResolution);
-
 	const TMovieSceneEvaluationTree<FMovieSceneSubSequenceTreeEntry>& SubSequenceTree = Hierarchy->GetTree();
 	FMovieSceneEvaluationTreeRangeIterator RangeIt =
 		SubSequenceTree.IterateFromTime(RootTime.FrameNumber);
 
 	if (RangeIt)
 	{
+		// 同じノードの範囲内は同じサブシーケンスの組なので、結果（見つからなかった場合も含む）を使い回せる
+		Resolved.ValidRange = RangeIt.Range();
+
 		for (const FMovieSceneSubSequenceTreeEntry& Entry : SubSequenceTree.GetAllData(RangeIt.Node()))
 		{
 			const FMovieSceneSequenceID SeqID = Entry.SequenceID;
@@ -138,7 +219,9 @@ ULevelSequence* TargetActorEditorModule::FindActiveLevelSequenceForActor(const A
 			}
 
 			UMovieSceneSequence* SubSequence = Hierarchy->FindSubSequence(SeqID);
-			return Cast<ULevelSequence>(SubSequence);
+			ULevelSequence* SubLevelSequence = Cast<ULevelSequence>(SubSequence);
+			Resolved.Result = SubLevelSequence;
+			return SubLevelSequence;
 		}
 	}
 #endif
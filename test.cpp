@@ -1,23 +1,19 @@
+#include "test.h"
+
 #include "Engine/World.h"
 #include "CollisionQueryParams.h"
+#include "SceneQueryRecorder.h"
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
 
-static bool SweepFocusSlabAndGetForwardDistance(
-    const UWorld* World,
+bool MakeFocusSlabQuery(
     const FVector& CamPos,
     const FQuat& CamRot,                 // カメラ回転
     const FVector& TargetCenterWorld,    // 被写体中心
     float SlabSizeCm,                    // 例: 200.0f (2m四方)
     float SlabThicknessCm,               // 例: 10.0f  (厚み10cm)
-    float& OutFocusDistanceCm,
-    FHitResult& OutHit)
+    FFocusSlabQuery& OutQuery)
 {
-    if (!World)
-    {
-        return false;
-    }
-
-    const FVector Forward = CamRot.GetForwardVector().GetSafeNormal();
-
     // 「板を飛ばす」方向：カメラ→被写体中心（あなたの要件通り）
     const FVector Dir = (TargetCenterWorld - CamPos).GetSafeNormal();
     if (Dir.IsNearlyZero())
@@ -25,8 +21,8 @@ static bool SweepFocusSlabAndGetForwardDistance(
         return false;
     }
 
-    const FVector Start = CamPos;
-    const FVector End   = TargetCenterWorld;
+    OutQuery.Start = CamPos;
+    OutQuery.End   = TargetCenterWorld;
 
     // 2m四方・厚み10cmの板（HalfExtentなので半分）
     // ここでは板の法線をカメラForwardに合わせ、板の厚みをForward方向に持たせます。
@@ -34,11 +30,56 @@ static bool SweepFocusSlabAndGetForwardDistance(
     const float HalfZ  = SlabThicknessCm * 0.5f;  // 5cm
     const FVector HalfExtent(HalfXY, HalfXY, HalfZ);
 
-    const FCollisionShape Shape = FCollisionShape::MakeBox(HalfExtent);
+    OutQuery.Shape = FCollisionShape::MakeBox(HalfExtent);
 
     // 板の向き：カメラと同じ（Z=Forward, X/Yが画面面内、というニュアンス）
     // ※ Boxの軸がどう割り当てられるかは「回転付きBox」として扱われるので、ここではCamRotでOKです。
-    const FQuat Orientation = CamRot;
+    OutQuery.Orientation = CamRot;
+    return true;
+}
+
+bool GetFocusDistanceFromHit(
+    const FVector& CamPos,
+    const FQuat& CamRot,
+    const FHitResult& Hit,
+    float& OutFocusDistanceCm)
+{
+    const FVector Forward = CamRot.GetForwardVector().GetSafeNormal();
+
+    // 欲しいのは「ヒット点Pの、カメラForward方向の深度」
+    const FVector P = Hit.ImpactPoint; // 基本これ。必要なら Hit.Location との使い分け
+    const float FocusDist = FVector::DotProduct((P - CamPos), Forward);
+
+    // 背面や数値誤差を除外したいなら
+    if (FocusDist <= 0.0f)
+    {
+        return false;
+    }
+
+    OutFocusDistanceCm = FocusDist;
+    return true;
+}
+
+static bool SweepFocusSlabAndGetForwardDistanceImpl(
+    const UWorld* World,
+    const FVector& CamPos,
+    const FQuat& CamRot,
+    const FVector& TargetCenterWorld,
+    float SlabSizeCm,
+    float SlabThicknessCm,
+    float& OutFocusDistanceCm,
+    FHitResult& OutHit)
+{
+    if (!World)
+    {
+        return false;
+    }
+
+    FFocusSlabQuery Query;
+    if (!MakeFocusSlabQuery(CamPos, CamRot, TargetCenterWorld, SlabSizeCm, SlabThicknessCm, Query))
+    {
+        return false;
+    }
 
     FCollisionObjectQueryParams ObjParams;
     ObjParams.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldDynamic);
@@ -47,11 +88,11 @@ static bool SweepFocusSlabAndGetForwardDistance(
 
     const bool bHit = World->SweepSingleByObjectType(
         OutHit,
-        Start,
-        End,
-        Orientation,
+        Query.Start,
+        Query.End,
+        Query.Orientation,
         ObjParams,
-        Shape,
+        Query.Shape,
         QueryParams
     );
 
@@ -60,16 +101,387 @@ static bool SweepFocusSlabAndGetForwardDistance(
         return false;
     }
 
-    // 欲しいのは「ヒット点Pの、カメラForward方向の深度」
-    const FVector P = OutHit.ImpactPoint; // 基本これ。必要なら OutHit.Location との使い分け
-    const float FocusDist = FVector::DotProduct((P - CamPos), Forward);
+    return GetFocusDistanceFromHit(CamPos, CamRot, OutHit, OutFocusDistanceCm);
+}
 
-    // 背面や数値誤差を除外したいなら
-    if (FocusDist <= 0.0f)
+bool SweepFocusSlabAndGetForwardDistance(
+    const UWorld* World,
+    const FVector& CamPos,
+    const FQuat& CamRot,
+    const FVector& TargetCenterWorld,
+    float SlabSizeCm,
+    float SlabThicknessCm,
+    float& OutFocusDistanceCm,
+    FHitResult& OutHit)
+{
+    if (!FSceneQueryRecorder::IsRecording())
+    {
+        return SweepFocusSlabAndGetForwardDistanceImpl(World, CamPos, CamRot, TargetCenterWorld, SlabSizeCm, SlabThicknessCm, OutFocusDistanceCm, OutHit);
+    }
+
+    // 記録中のみ計測（入力・結果・所要時間）
+    const double StartSeconds = FPlatformTime::Seconds();
+    const bool bHit = SweepFocusSlabAndGetForwardDistanceImpl(World, CamPos, CamRot, TargetCenterWorld, SlabSizeCm, SlabThicknessCm, OutFocusDistanceCm, OutHit);
+    const double Duration = FPlatformTime::Seconds() - StartSeconds;
+
+    FFocusSlabRecord Record;
+    Record.CamPos = CamPos;
+    Record.CamRot = CamRot;
+    Record.TargetCenter = TargetCenterWorld;
+    Record.SlabSizeCm = SlabSizeCm;
+    Record.SlabThicknessCm = SlabThicknessCm;
+    Record.bHit = bHit;
+    Record.FocusDistanceCm = bHit ? OutFocusDistanceCm : 0.0f;
+    FSceneQueryRecorder::RecordFocusSlab(Record, Duration);
+
+    return bHit;
+}
+
+bool EstimateFocusDistanceMultiSample(
+    const UWorld* World,
+    const FVector& CamPos,
+    const FQuat& CamRot,
+    const FVector& TargetCenterWorld,
+    const FFocusSampleSettings& Settings,
+    FFocusEstimate& OutEstimate)
+{
+    OutEstimate = FFocusEstimate();
+
+    if (!World)
     {
         return false;
     }
 
-    OutFocusDistanceCm = FocusDist;
+    const int32 GridSize = FMath::Max(Settings.GridSize, 1);
+    const int32 NumSamples = GridSize * GridSize;
+
+    const FVector Forward = CamRot.GetForwardVector().GetSafeNormal();
+    const FVector Right = CamRot.GetRightVector();
+    const FVector Up = CamRot.GetUpVector();
+
+    const float HalfSize = Settings.PatternSizeCm * 0.5f;
+    const float Step = GridSize > 1 ? Settings.PatternSizeCm / (GridSize - 1) : 0.0f;
+
+    struct FSample
+    {
+        float Depth = 0.0f;
+        float Weight = 0.0f;
+        bool bHit = false;
+    };
+    TArray<FSample> Samples;
+    Samples.SetNum(NumSamples);
+
+    FCollisionObjectQueryParams ObjParams;
+    ObjParams.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldDynamic);
+
+    const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FocusMultiSample), /*bTraceComplex=*/false);
+
+    // 1本ずつは軽いので、少ない時は呼び出しスレッドでそのまま回す
+    const EParallelForFlags Flags = NumSamples >= 16 ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread;
+
+    ParallelFor(NumSamples, [&](const int32 Index)
+    {
+        const float U = GridSize > 1 ? -HalfSize + Step * (Index % GridSize) : 0.0f;
+        const float V = GridSize > 1 ? -HalfSize + Step * (Index / GridSize) : 0.0f;
+
+        // 中心からの距離（四隅で 1）で重みを下げる
+        const float Radial = HalfSize > 0.0f ? FMath::Sqrt(U * U + V * V) / (HalfSize * UE_SQRT_2) : 0.0f;
+
+        FSample& Sample = Samples[Index];
+        Sample.Weight = FMath::Lerp(1.0f, Settings.EdgeWeight, Radial);
+
+        const FVector Point = TargetCenterWorld + Right * U + Up * V;
+        const FVector ToPoint = Point - CamPos;
+        const float PointDistance = ToPoint.Size();
+        if (PointDistance <= KINDA_SMALL_NUMBER)
+        {
+            return;
+        }
+
+        const FVector End = CamPos + ToPoint / PointDistance * (PointDistance + Settings.OvershootCm);
+
+        FHitResult Hit;
+        if (!World->LineTraceSingleByObjectType(Hit, CamPos, End, ObjParams, QueryParams))
+        {
+            return;
+        }
+
+        const float Depth = FVector::DotProduct(Hit.ImpactPoint - CamPos, Forward);
+        if (Depth > 0.0f)
+        {
+            Sample.Depth = Depth;
+            Sample.bHit = true;
+        }
+    }, Flags);
+
+    TArray<FSample> Hits;
+    float TotalWeight = 0.0f;
+    float HitWeight = 0.0f;
+    for (const FSample& Sample : Samples)
+    {
+        TotalWeight += Sample.Weight;
+        if (Sample.bHit)
+        {
+            Hits.Add(Sample);
+            HitWeight += Sample.Weight;
+        }
+    }
+
+    OutEstimate.NumSamples = NumSamples;
+    OutEstimate.NumHits = Hits.Num();
+
+    if (Hits.Num() == 0 || HitWeight <= 0.0f)
+    {
+        return false;
+    }
+
+    // 重み付きパーセンタイル（ヒットしたサンプルのみで）
+    Hits.Sort([](const FSample& A, const FSample& B) { return A.Depth < B.Depth; });
+
+    const float TargetWeight = FMath::Clamp(Settings.Percentile, 0.0f, 1.0f) * HitWeight;
+    float Cumulative = 0.0f;
+    float Estimate = Hits.Last().Depth;
+    for (const FSample& Sample : Hits)
+    {
+        Cumulative += Sample.Weight;
+        if (Cumulative >= TargetWeight)
+        {
+            Estimate = Sample.Depth;
+            break;
+        }
+    }
+
+    float AgreeingWeight = 0.0f;
+    for (const FSample& Sample : Hits)
+    {
+        if (FMath::Abs(Sample.Depth - Estimate) <= Settings.AgreementToleranceCm)
+        {
+            AgreeingWeight += Sample.Weight;
+        }
+    }
+
+    OutEstimate.FocusDistanceCm = Estimate;
+    OutEstimate.Confidence = TotalWeight > 0.0f ? AgreeingWeight / TotalWeight : 0.0f;
     return true;
-}
\ No newline at end of file
+}
+
+bool FFocusSlabCache::TryGet(
+    const UWorld* World,
+    const FVector& InCamPos,
+    const FQuat& InCamRot,
+    const FVector& InTargetCenter,
+    const float InSlabSizeCm,
+    const float InSlabThicknessCm,
+    bool& bOutHit,
+    float& OutFocusDistanceCm) const
+{
+    if (!bValid || CachedWorld.Get() != World)
+    {
+        return false;
+    }
+
+    if (Tolerances.MaxAgeSeconds > 0.0f && FPlatformTime::Seconds() - StoredTimeSeconds > Tolerances.MaxAgeSeconds)
+    {
+        return false;
+    }
+
+    // 板の寸法は許容なし（変わったら取り直す）
+    if (InSlabSizeCm != SlabSizeCm || InSlabThicknessCm != SlabThicknessCm)
+    {
+        return false;
+    }
+
+    if (!IsPoseWithinTolerances(InCamPos, InCamRot, InTargetCenter, CamPos, CamRot, TargetCenter))
+    {
+        return false;
+    }
+
+    // 通り道の周辺のプリミティブが動いた・消えたなら取り直す
+    for (const FTrackedPrimitive& Tracked : TrackedPrimitives)
+    {
+        const UPrimitiveComponent* Component = Tracked.Component.Get();
+        if (!Component)
+        {
+            return false;
+        }
+
+        // FTransform::Equals は同じ許容を回転の成分にも当てるので、移動と回転は別々に見る
+        const FTransform& Current = Component->GetComponentTransform();
+        if (FVector::DistSquared(Current.GetLocation(), Tracked.Transform.GetLocation()) > FMath::Square(Tolerances.PrimitivePositionCm)
+            || FMath::RadiansToDegrees(Current.GetRotation().AngularDistance(Tracked.Transform.GetRotation())) > Tolerances.PrimitiveRotationDeg
+            || !Current.GetScale3D().Equals(Tracked.Transform.GetScale3D(), KINDA_SMALL_NUMBER))
+        {
+            return false;
+        }
+    }
+
+    bOutHit = bHit;
+    OutFocusDistanceCm = FocusDistanceCm;
+    return true;
+}
+
+bool FFocusSlabCache::IsPoseWithinTolerances(
+    const FVector& CamPosA,
+    const FQuat& CamRotA,
+    const FVector& TargetCenterA,
+    const FVector& CamPosB,
+    const FQuat& CamRotB,
+    const FVector& TargetCenterB) const
+{
+    return FVector::DistSquared(CamPosA, CamPosB) <= FMath::Square(Tolerances.CameraPositionCm)
+        && FVector::DistSquared(TargetCenterA, TargetCenterB) <= FMath::Square(Tolerances.TargetPositionCm)
+        && FMath::RadiansToDegrees(CamRotA.AngularDistance(CamRotB)) <= Tolerances.CameraRotationDeg;
+}
+
+bool FFocusSlabCache::NoteMissAndShouldStore(const FVector& InCamPos, const FQuat& InCamRot, const FVector& InTargetCenter)
+{
+    if (bHasMissPose && IsPoseWithinTolerances(InCamPos, InCamRot, InTargetCenter, MissCamPos, MissCamRot, MissTargetCenter))
+    {
+        ++NumStationaryMisses;
+    }
+    else
+    {
+        NumStationaryMisses = 0;
+    }
+
+    bHasMissPose = true;
+    MissCamPos = InCamPos;
+    MissCamRot = InCamRot;
+    MissTargetCenter = InTargetCenter;
+
+    return NumStationaryMisses >= StationaryQueriesBeforeStore;
+}
+
+bool FFocusSlabCache::GetGatherBounds(
+    const FVector& InCamPos,
+    const FQuat& InCamRot,
+    const FVector& InTargetCenter,
+    const float InSlabSizeCm,
+    const float InSlabThicknessCm,
+    FBox& OutBounds) const
+{
+    FFocusSlabQuery Query;
+    if (!MakeFocusSlabQuery(InCamPos, InCamRot, InTargetCenter, InSlabSizeCm, InSlabThicknessCm, Query))
+    {
+        return false;
+    }
+
+    // 板の通り道（始点・終点での回転付きBoxの AABB の和）+ 余白
+    const FBox LocalBox(-Query.Shape.GetExtent(), Query.Shape.GetExtent());
+    OutBounds = LocalBox.TransformBy(FTransform(Query.Orientation, Query.Start));
+    OutBounds += LocalBox.TransformBy(FTransform(Query.Orientation, Query.End));
+    OutBounds = OutBounds.ExpandBy(Tolerances.EntryMarginCm);
+    return true;
+}
+
+void FFocusSlabCache::Store(
+    const UWorld* World,
+    const FVector& InCamPos,
+    const FQuat& InCamRot,
+    const FVector& InTargetCenter,
+    const float InSlabSizeCm,
+    const float InSlabThicknessCm,
+    const bool bInHit,
+    const float InFocusDistanceCm)
+{
+    FBox SweptBounds;
+    if (!World || !GetGatherBounds(InCamPos, InCamRot, InTargetCenter, InSlabSizeCm, InSlabThicknessCm, SweptBounds))
+    {
+        Invalidate();
+        return;
+    }
+
+    FCollisionObjectQueryParams ObjParams;
+    ObjParams.AddObjectTypesToQuery(ECollisionChannel::ECC_WorldDynamic);
+
+    const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(FocusSlabCacheGather), /*bTraceComplex=*/false);
+
+    TArray<FOverlapResult> Overlaps;
+    World->OverlapMultiByObjectType(
+        Overlaps,
+        SweptBounds.GetCenter(),
+        FQuat::Identity,
+        ObjParams,
+        FCollisionShape::MakeBox(SweptBounds.GetExtent()),
+        QueryParams
+    );
+
+    Store(World, InCamPos, InCamRot, InTargetCenter, InSlabSizeCm, InSlabThicknessCm, bInHit, InFocusDistanceCm, Overlaps);
+}
+
+void FFocusSlabCache::Store(
+    const UWorld* World,
+    const FVector& InCamPos,
+    const FQuat& InCamRot,
+    const FVector& InTargetCenter,
+    const float InSlabSizeCm,
+    const float InSlabThicknessCm,
+    const bool bInHit,
+    const float InFocusDistanceCm,
+    const TConstArrayView<FOverlapResult> Overlaps)
+{
+    Invalidate();
+
+    if (!World)
+    {
+        return;
+    }
+
+    for (const FOverlapResult& Overlap : Overlaps)
+    {
+        if (const UPrimitiveComponent* Component = Overlap.GetComponent())
+        {
+            FTrackedPrimitive& Tracked = TrackedPrimitives.AddDefaulted_GetRef();
+            Tracked.Component = Component;
+            Tracked.Transform = Component->GetComponentTransform();
+        }
+    }
+
+    bValid = true;
+    CachedWorld = World;
+    StoredTimeSeconds = FPlatformTime::Seconds();
+
+    CamPos = InCamPos;
+    CamRot = InCamRot;
+    TargetCenter = InTargetCenter;
+    SlabSizeCm = InSlabSizeCm;
+    SlabThicknessCm = InSlabThicknessCm;
+
+    bHit = bInHit;
+    FocusDistanceCm = InFocusDistanceCm;
+}
+
+bool SweepFocusSlabAndGetForwardDistanceCached(
+    FFocusSlabCache& Cache,
+    const UWorld* World,
+    const FVector& CamPos,
+    const FQuat& CamRot,
+    const FVector& TargetCenterWorld,
+    float SlabSizeCm,
+    float SlabThicknessCm,
+    float& OutFocusDistanceCm)
+{
+    bool bCachedHit = false;
+    if (Cache.TryGet(World, CamPos, CamRot, TargetCenterWorld, SlabSizeCm, SlabThicknessCm, bCachedHit, OutFocusDistanceCm))
+    {
+        return bCachedHit;
+    }
+
+    const bool bStore = Cache.NoteMissAndShouldStore(CamPos, CamRot, TargetCenterWorld);
+
+    FHitResult Hit;
+    float Distance = 0.0f;
+    const bool bHit = SweepFocusSlabAndGetForwardDistance(World, CamPos, CamRot, TargetCenterWorld, SlabSizeCm, SlabThicknessCm, Distance, Hit);
+
+    // 周辺を集める同期 Overlap は静止している時だけ（動いている間はスイープ1回分のコストのまま）
+    if (bStore)
+    {
+        Cache.Store(World, CamPos, CamRot, TargetCenterWorld, SlabSizeCm, SlabThicknessCm, bHit, Distance);
+    }
+
+    if (bHit)
+    {
+        OutFocusDistanceCm = Distance;
+    }
+    return bHit;
+}
@@ -0,0 +1,244 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "CollisionShape.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UWorld;
+class UPrimitiveComponent;
+struct FOverlapResult;
+
+/**
+ * カメラ前方の被写体までのフォーカス距離を、板（薄いBox）のスイープで求めます。
+ *
+ * - 板はカメラ→被写体中心の向きに飛ばし、向きはカメラ回転に合わせる
+ * - 距離はヒット点のカメラForward方向の深度
+ * - SceneQueryRecorder で記録中なら入力・結果・所要時間を記録
+ */
+bool SweepFocusSlabAndGetForwardDistance(
+    const UWorld* World,
+    const FVector& CamPos,
+    const FQuat& CamRot,                 // カメラ回転
+    const FVector& TargetCenterWorld,    // 被写体中心
+    float SlabSizeCm,                    // 例: 200.0f (2m四方)
+    float SlabThicknessCm,               // 例: 10.0f  (厚み10cm)
+    float& OutFocusDistanceCm,
+    FHitResult& OutHit);
+
+/** フォーカス板スイープ1回分の形状・区間（同期・非同期どちらのスイープにも使う） */
+struct FFocusSlabQuery
+{
+    FVector Start = FVector::ZeroVector;
+    FVector End = FVector::ZeroVector;
+    FQuat Orientation = FQuat::Identity;
+    FCollisionShape Shape;
+};
+
+/** 板の形状・区間を作る。カメラと被写体中心が重なっている場合は false */
+bool MakeFocusSlabQuery(
+    const FVector& CamPos,
+    const FQuat& CamRot,
+    const FVector& TargetCenterWorld,
+    float SlabSizeCm,
+    float SlabThicknessCm,
+    FFocusSlabQuery& OutQuery);
+
+/** ヒット点のカメラForward方向の深度。カメラの後ろなら false */
+bool GetFocusDistanceFromHit(
+    const FVector& CamPos,
+    const FQuat& CamRot,
+    const FHitResult& Hit,
+    float& OutFocusDistanceCm);
+
+/** 多点サンプリングでのフォーカス推定の設定 */
+struct FFocusSampleSettings
+{
+    /** GridSize x GridSize 本のライントレース */
+    int32 GridSize = 5;
+
+    /** サンプル点を並べる正方形の一辺（cm）。被写体中心を通り、カメラForwardに垂直な面に置く */
+    float PatternSizeCm = 200.0f;
+
+    /** サンプル点の先へ延長する距離（cm）。被写体の奥側の面まで拾うため */
+    float OvershootCm = 100.0f;
+
+    /** 採用する深度の重み付きパーセンタイル（0.5 = 中央値。小さいほど手前寄り） */
+    float Percentile = 0.5f;
+
+    /** 四隅のサンプルの重み（中心は 1、間は距離で線形に補間） */
+    float EdgeWeight = 0.5f;
+
+    /** 推定値からこの範囲（cm）に入ったヒットを「一致」とみなして信頼度に数える */
+    float AgreementToleranceCm = 20.0f;
+};
+
+/** 多点サンプリングでのフォーカス推定結果 */
+struct FFocusEstimate
+{
+    float FocusDistanceCm = 0.0f;
+
+    /** 推定値に一致したサンプルの重み / 全サンプルの重み（0..1）。外れ・ばらつきが多いほど低い */
+    float Confidence = 0.0f;
+
+    int32 NumHits = 0;
+    int32 NumSamples = 0;
+};
+
+/**
+ * 被写体中心の周りに格子状に並べた点へライントレースを1バッチ（並列）で飛ばし、
+ * ヒット点のカメラForward深度の重み付きパーセンタイルをフォーカス距離とします。
+ *
+ * - 板スイープと違い、手前を横切る細い物体が1本のレイに当たっても推定値はほとんど動かない
+ * - 対象は板スイープと同じ WorldDynamic
+ * - 1本も当たらなければ false
+ */
+bool EstimateFocusDistanceMultiSample(
+    const UWorld* World,
+    const FVector& CamPos,
+    const FQuat& CamRot,
+    const FVector& TargetCenterWorld,
+    const FFocusSampleSettings& Settings,
+    FFocusEstimate& OutEstimate);
+
+/**
+ * フォーカス板スイープの結果キャッシュ。
+ *
+ * カメラ・被写体・板の寸法が許容範囲内で、板の通り道の周辺にある WorldDynamic のプリミティブも
+ * 動いていなければ、前回の結果をそのまま返してスイープを省きます。
+ *
+ * - 周辺のプリミティブは結果を保存する時に1回の Overlap で集め、以降はその Transform の比較だけで判定
+ * - 保存（Overlap）は静止したクエリが StationaryQueriesBeforeStore 回続いた時だけ（動いている間はすぐ外れるので集めない）
+ * - 集めた範囲（通り道 + EntryMarginCm）の外から入ってきた物体は検出できないため、MaxAgeSeconds で必ず取り直す
+ * - ゲームスレッドのみ
+ */
+class FFocusSlabCache
+{
+public:
+    struct FTolerances
+    {
+        float CameraPositionCm = 1.0f;
+        float CameraRotationDeg = 0.1f;
+        float TargetPositionCm = 1.0f;
+
+        /** 周辺プリミティブの移動の許容（cm） */
+        float PrimitivePositionCm = 0.5f;
+
+        /** 周辺プリミティブの回転の許容（度） */
+        float PrimitiveRotationDeg = 0.1f;
+
+        /** 周辺プリミティブを集める範囲の、通り道からの余白（cm） */
+        float EntryMarginCm = 100.0f;
+
+        /** これより古い結果は使わない（秒。0 以下なら無制限） */
+        float MaxAgeSeconds = 1.0f;
+    };
+
+    FTolerances Tolerances;
+
+    /** キャッシュが外れたクエリが、前回外れた時と許容内の姿勢でこの回数続くまでは保存しない */
+    int32 StationaryQueriesBeforeStore = 2;
+
+    /**
+     * キャッシュが外れたクエリの姿勢を記録し、その結果を保存する（周辺の Overlap を掛ける）価値があるかを返す。
+     * カメラ・被写体が動き続けている間は、保存してもすぐ外れるので false
+     */
+    bool NoteMissAndShouldStore(const FVector& CamPos, const FQuat& CamRot, const FVector& TargetCenterWorld);
+
+    /** 2つの姿勢（カメラ位置・回転・被写体中心）の差が Tolerances 以内か */
+    bool IsPoseWithinTolerances(
+        const FVector& CamPosA,
+        const FQuat& CamRotA,
+        const FVector& TargetCenterA,
+        const FVector& CamPosB,
+        const FQuat& CamRotB,
+        const FVector& TargetCenterB) const;
+
+    /** 前回の結果がそのまま使えれば true（bOutHit / OutFocusDistanceCm に前回の結果） */
+    bool TryGet(
+        const UWorld* World,
+        const FVector& CamPos,
+        const FQuat& CamRot,
+        const FVector& TargetCenterWorld,
+        float SlabSizeCm,
+        float SlabThicknessCm,
+        bool& bOutHit,
+        float& OutFocusDistanceCm) const;
+
+    /** 周辺のプリミティブを集める範囲（通り道 + EntryMarginCm の AABB）。板が作れなければ false */
+    bool GetGatherBounds(
+        const FVector& CamPos,
+        const FQuat& CamRot,
+        const FVector& TargetCenterWorld,
+        float SlabSizeCm,
+        float SlabThicknessCm,
+        FBox& OutBounds) const;
+
+    /** スイープ結果を保存し、通り道の周辺のプリミティブを集め直す（ゲームスレッドで同期 Overlap） */
+    void Store(
+        const UWorld* World,
+        const FVector& CamPos,
+        const FQuat& CamRot,
+        const FVector& TargetCenterWorld,
+        float SlabSizeCm,
+        float SlabThicknessCm,
+        bool bHit,
+        float FocusDistanceCm);
+
+    /** スイープ結果を、別に集めた周辺のプリミティブ（GetGatherBounds の範囲の WorldDynamic）と一緒に保存する */
+    void Store(
+        const UWorld* World,
+        const FVector& CamPos,
+        const FQuat& CamRot,
+        const FVector& TargetCenterWorld,
+        float SlabSizeCm,
+        float SlabThicknessCm,
+        bool bHit,
+        float FocusDistanceCm,
+        TConstArrayView<FOverlapResult> Overlaps);
+
+    void Invalidate() { bValid = false; TrackedPrimitives.Reset(); }
+
+private:
+    struct FTrackedPrimitive
+    {
+        TWeakObjectPtr<const UPrimitiveComponent> Component;
+        FTransform Transform;
+    };
+
+    bool bValid = false;
+    TWeakObjectPtr<const UWorld> CachedWorld;
+    double StoredTimeSeconds = 0.0;
+
+    FVector CamPos = FVector::ZeroVector;
+    FQuat CamRot = FQuat::Identity;
+    FVector TargetCenter = FVector::ZeroVector;
+    float SlabSizeCm = 0.0f;
+    float SlabThicknessCm = 0.0f;
+
+    bool bHit = false;
+    float FocusDistanceCm = 0.0f;
+
+    TArray<FTrackedPrimitive> TrackedPrimitives;
+
+    /** 直前にキャッシュが外れたクエリの姿勢と、許容内で続いた回数 */
+    bool bHasMissPose = false;
+    FVector MissCamPos = FVector::ZeroVector;
+    FQuat MissCamRot = FQuat::Identity;
+    FVector MissTargetCenter = FVector::ZeroVector;
+    int32 NumStationaryMisses = 0;
+};
+
+/**
+ * SweepFocusSlabAndGetForwardDistance の結果を Cache に通す版（何も動いていなければスイープしない）。
+ * キャッシュが外れ、かつ静止していると判定された時は、保存のための Overlap が呼び出し元のスレッドで1回追加で掛かる
+ */
+bool SweepFocusSlabAndGetForwardDistanceCached(
+    FFocusSlabCache& Cache,
+    const UWorld* World,
+    const FVector& CamPos,
+    const FQuat& CamRot,
+    const FVector& TargetCenterWorld,
+    float SlabSizeCm,
+    float SlabThicknessCm,
+    float& OutFocusDistanceCm);